@@ -0,0 +1,455 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/spec/FrontierBasedSearch.hpp>
+#include <tdzdd/spec/LinearConstraints.hpp>
+#include <tdzdd/spec/PathZdd.hpp>
+#include <tdzdd/spec/SizeConstraint.hpp>
+#include <tdzdd/util/CPUAffinity.hpp>
+#include <tdzdd/util/Graph.hpp>
+#include <tdzdd/util/IntSubset.hpp>
+#include <tdzdd/util/PerfCounter.hpp>
+#include <tdzdd/util/ResourceUsage.hpp>
+
+#include "../ddqueens/NQueenZdd.hpp"
+#ifdef USE_CUDD
+#include "../cnfbdd/CnfToBdd.hpp"
+#endif
+
+using namespace tdzdd;
+
+std::string options[][2] = { //
+        {"full", "Use the full problem sizes"}, //
+        {"serial", "Run the serial algorithms only"}, //
+        {"mp", "Run the parallel algorithms only"}, //
+        {"perf", "Print hardware counters per phase to STDERR"}, //
+        {"numa", "Bind threads across NUMA nodes and print memory per node"
+                " after the build to STDERR"}, //
+        {"list", "List the workloads and exit"}};
+
+std::map<std::string,bool> opt;
+int repeats = 3;
+std::vector<std::string> filters;
+
+void usage(char const* cmd) {
+    std::cerr << "usage: " << cmd
+            << " <option>... [-r <repeats>] [<workload>...]\n";
+    std::cerr << "options\n";
+    for (unsigned i = 0; i < sizeof(options) / sizeof(options[0]); ++i) {
+        std::cerr << "  -" << options[i][0];
+        for (unsigned j = options[i][0].length(); j < 10; ++j) {
+            std::cerr << " ";
+        }
+        std::cerr << ": " << options[i][1] << "\n";
+    }
+    std::cerr << "  -r <n>     : Repeat each run <n> times (default: 3)\n";
+    std::cerr << "Only the workloads whose names contain one of the given "
+            "strings are run.\n";
+}
+
+std::string to_string(int i) {
+    std::ostringstream oss;
+    oss << i;
+    return oss.str();
+}
+
+/**
+ * Linear congruential generator with a fixed seed,
+ * so that the random instances are the same on every platform.
+ */
+class Random {
+    uint64_t x;
+
+public:
+    Random(uint64_t seed)
+            : x(seed * 2 + 1) {
+    }
+
+    int next(int lo, int hi) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        return lo + int((x >> 33) % uint64_t(hi - lo + 1));
+    }
+};
+
+/**
+ * Measurements of one run.
+ * Negative times mean that the phase is not applicable.
+ */
+struct Result {
+    double build;
+    double reduce;
+    double eval;
+    double subset;
+    size_t nodes;
+    size_t reduced;
+    size_t subsetNodes;
+    std::string card;
+    std::vector<uint64_t> numa; ///< Bytes per NUMA node after the build.
+
+    Result()
+            : build(-1), reduce(-1), eval(-1), subset(-1), nodes(0),
+              reduced(0), subsetNodes(0) {
+    }
+
+    bool sameCounts(Result const& o) const {
+        return nodes == o.nodes && reduced == o.reduced
+                && subsetNodes == o.subsetNodes && card == o.card;
+    }
+
+    void takeMin(Result const& o) {
+        if (o.build < build) numa = o.numa;
+        build = std::min(build, o.build);
+        reduce = std::min(reduce, o.reduce);
+        eval = std::min(eval, o.eval);
+        subset = std::min(subset, o.subset);
+    }
+};
+
+/**
+ * Builds, reduces and counts a ZDD and then takes its subset of
+ * the combinations with at most half of the items.
+ */
+template<typename SPEC>
+Result runZdd(SPEC const& spec, int numVars, bool useMP) {
+    Result r;
+    double t = getWallClockTime();
+    DdStructure<2> dd(spec, useMP);
+    r.build = getWallClockTime() - t;
+    r.nodes = dd.size();
+    if (opt["numa"]) r.numa = CPUAffinity::memoryPerNode();
+
+    t = getWallClockTime();
+    dd.zddReduce();
+    r.reduce = getWallClockTime() - t;
+    r.reduced = dd.size();
+
+    t = getWallClockTime();
+    r.card = dd.zddCardinality();
+    r.eval = getWallClockTime() - t;
+
+    IntRange half(0, numVars / 2);
+    t = getWallClockTime();
+    dd.zddSubset(SizeConstraint(numVars, &half));
+    dd.zddReduce();
+    r.subset = getWallClockTime() - t;
+    r.subsetNodes = dd.size();
+    return r;
+}
+
+/**
+ * Builds, reduces and counts a BDD.
+ */
+template<typename SPEC>
+Result runBdd(SPEC const& spec, int numVars, bool useMP) {
+    Result r;
+    double t = getWallClockTime();
+    DdStructure<2> dd(spec, useMP);
+    r.build = getWallClockTime() - t;
+    r.nodes = dd.size();
+    if (opt["numa"]) r.numa = CPUAffinity::memoryPerNode();
+
+    t = getWallClockTime();
+    dd.bddReduce();
+    r.reduce = getWallClockTime() - t;
+    r.reduced = dd.size();
+
+    t = getWallClockTime();
+    r.card = dd.bddCardinality(numVars);
+    r.eval = getWallClockTime() - t;
+    return r;
+}
+
+/**
+ * Makes an n x n grid graph whose vertices are numbered in row-major order.
+ * The path terminals are the two opposite corners.
+ */
+void makeGrid(Graph& g, int n) {
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            int v = i * n + j + 1;
+            if (j + 1 < n) g.addEdge(to_string(v), to_string(v + 1));
+            if (i + 1 < n) g.addEdge(to_string(v), to_string(v + n));
+        }
+    }
+    g.update();
+    g.setDefaultPathColor();
+}
+
+Result gridPath(int n, bool useMP) {
+    Graph g;
+    makeGrid(g, n);
+    return runZdd(PathZdd(g), g.edgeSize(), useMP);
+}
+
+Result gridFbs(int n, bool useMP) {
+    Graph g;
+    makeGrid(g, n);
+    return runZdd(FrontierBasedSearch(g, -1, false, true), g.edgeSize(),
+            useMP);
+}
+
+Result queens(int n, bool useMP) {
+    return runZdd(NQueenZdd(n), n * n, useMP);
+}
+
+/**
+ * 0-1 knapsack with n items whose weights are in [1,100]
+ * and the capacity is half of the total weight.
+ */
+Result knapsack(int n, bool useMP) {
+    Random rand(n);
+    LinearConstraints<int> lc(n);
+    std::map<int,int> expr;
+    int total = 0;
+    for (int i = 0; i < n; ++i) {
+        int w = rand.next(1, 100);
+        expr[i] = w;
+        total += w;
+    }
+    lc.addConstraint(expr, 0, total / 2);
+    lc.update();
+    return runZdd(lc, n, useMP);
+}
+
+#ifdef USE_CUDD
+/**
+ * Random 3-SAT with n variables and 4.26n clauses.
+ */
+Result sat3(int n, bool useMP) {
+    Random rand(n);
+    int m = n * 426 / 100;
+    std::stringstream ss;
+    ss << "p cnf " << n << " " << m << "\n";
+    for (int k = 0; k < m; ++k) {
+        for (int l = 0; l < 3; ++l) {
+            int v = rand.next(1, n);
+            ss << (rand.next(0, 1) ? v : -v) << " ";
+        }
+        ss << "0\n";
+    }
+
+    CnfToBdd cnf;
+    cnf.load(ss, false);
+    cnf.useClauseMap(true);
+    cnf.traverse(size_t(-1));
+    return runBdd(cnf, cnf.numVars(), useMP);
+}
+#endif
+
+struct Workload {
+    char const* name;
+    Result (*run)(int n, bool useMP);
+    int small[2]; ///< Size range of the default suite.
+    int full[2];  ///< Size range of the full suite.
+};
+
+Workload const workloads[] = { //
+        {"grid-path", gridPath, {4, 8}, {4, 10}}, //
+        {"grid-fbs", gridFbs, {4, 7}, {4, 9}}, //
+        {"queens", queens, {8, 12}, {8, 15}}, //
+        {"knapsack", knapsack, {40, 100}, {40, 200}}, //
+#ifdef USE_CUDD
+        {"3sat", sat3, {40, 60}, {40, 100}}, //
+#endif
+        };
+
+int const numWorkloads = sizeof(workloads) / sizeof(workloads[0]);
+
+bool selected(std::string const& name) {
+    if (filters.empty()) return true;
+    for (size_t i = 0; i < filters.size(); ++i) {
+        if (name.find(filters[i]) != std::string::npos) return true;
+    }
+    return false;
+}
+
+int sizeStep(Workload const& w) {
+    return (w.full[1] - w.full[0] >= 40) ? 20 : 1;
+}
+
+void printTime(std::ostream& os, double t) {
+    if (t < 0) {
+        os << std::setw(10) << "-";
+    }
+    else {
+        os << std::setw(10) << std::fixed << std::setprecision(4) << t;
+    }
+}
+
+void printHeader(std::ostream& os) {
+    os << "#" << std::setw(11) << "workload" << std::setw(5) << "size"
+            << std::setw(7) << "mode" << std::setw(4) << "thr"
+            << std::setw(10) << "build" << std::setw(10) << "reduce"
+            << std::setw(10) << "eval" << std::setw(10) << "subset"
+            << std::setw(12) << "nodes" << std::setw(12) << "reduced"
+            << std::setw(12) << "subnodes" << std::setw(10) << "rss_mb"
+            << std::setw(12) << "nodes/s" << "  cardinality\n";
+}
+
+void printResult(std::ostream& os, Workload const& w, int n, bool useMP,
+        int threads, Result const& r, bool stable) {
+    os << std::setw(12) << w.name << std::setw(5) << n << std::setw(7)
+            << (useMP ? "mp" : "serial") << std::setw(4) << threads;
+    printTime(os, r.build);
+    printTime(os, r.reduce);
+    printTime(os, r.eval);
+    printTime(os, r.subset);
+    os << std::setw(12) << r.nodes << std::setw(12) << r.reduced;
+    if (r.subset < 0) {
+        os << std::setw(12) << "-";
+    }
+    else {
+        os << std::setw(12) << r.subsetNodes;
+    }
+    ResourceUsage usage;
+    os << std::setw(10) << std::fixed << std::setprecision(1)
+            << usage.maxrss / 1024.0;
+    os << std::setw(12) << std::setprecision(0)
+            << (r.build > 0 ? r.nodes / r.build : 0);
+    os << "  " << r.card << (stable ? "" : " !unstable") << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    for (unsigned i = 0; i < sizeof(options) / sizeof(options[0]); ++i) {
+        opt[options[i][0]] = false;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        std::string s = argv[i];
+        if (s == "-r" && i + 1 < argc) {
+            repeats = std::atoi(argv[++i]);
+        }
+        else if (s[0] == '-') {
+            s = s.substr(1);
+            if (opt.count(s)) {
+                opt[s] = true;
+            }
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else {
+            filters.push_back(s);
+        }
+    }
+
+    if (repeats < 1 || (opt["serial"] && opt["mp"])) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (opt["list"]) {
+        for (int k = 0; k < numWorkloads; ++k) {
+            Workload const& w = workloads[k];
+            std::cout << w.name << " " << w.small[0] << ".." << w.small[1]
+                    << " (full: " << w.full[0] << ".." << w.full[1]
+                    << ")\n";
+        }
+        return 0;
+    }
+
+    if (opt["perf"]) {
+        PerfProfile::enable();
+        if (!PerfProfile::countersAvailable()) {
+            std::cerr << "# hardware counters are not available;"
+                    " only the time is profiled\n";
+        }
+    }
+
+    if (opt["numa"]) CPUAffinity::enable();
+
+    int threads = 1;
+#ifdef _OPENMP
+    threads = omp_get_max_threads();
+#endif
+
+    std::cout << "# ddbench repeats=" << repeats << " suite="
+            << (opt["full"] ? "full" : "default") << " threads=" << threads
+            << "\n";
+    std::cout << "# times are the minimum wall-clock seconds over the repeats;"
+            " rss_mb is the peak RSS of the process\n";
+    printHeader(std::cout);
+
+    try {
+        for (int k = 0; k < numWorkloads; ++k) {
+            Workload const& w = workloads[k];
+            if (!selected(w.name)) continue;
+            int const* range = opt["full"] ? w.full : w.small;
+            int step = sizeStep(w);
+
+            for (int n = range[0]; n <= range[1]; n += step) {
+                for (int mp = 0; mp <= 1; ++mp) {
+                    if (mp ? opt["serial"] : opt["mp"]) continue;
+                    Result best = w.run(n, mp);
+                    bool stable = true;
+                    for (int t = 1; t < repeats; ++t) {
+                        Result r = w.run(n, mp);
+                        if (!r.sameCounts(best)) stable = false;
+                        best.takeMin(r);
+                    }
+                    printResult(std::cout, w, n, mp, mp ? threads : 1, best,
+                            stable);
+                    if (opt["numa"]) {
+                        std::cerr << "# " << w.name << " " << n << " "
+                                << (mp ? "mp" : "serial") << " numa_mb";
+                        if (best.numa.empty()) std::cerr << " -";
+                        for (size_t k = 0; k < best.numa.size(); ++k) {
+                            std::cerr << " N" << k << "="
+                                    << std::fixed << std::setprecision(1)
+                                    << best.numa[k] / 1048576.0;
+                        }
+                        std::cerr << "\n";
+                    }
+                    if (opt["perf"]) {
+                        std::cerr << "# " << w.name << " " << n << " "
+                                << (mp ? "mp" : "serial") << "\n";
+                        PerfProfile::print(std::cerr);
+                        PerfProfile::clear();
+                    }
+                }
+            }
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
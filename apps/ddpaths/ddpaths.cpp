@@ -35,6 +35,7 @@
 #include <tdzdd/spec/DegreeConstraint.hpp>
 #include <tdzdd/spec/FrontierBasedSearch.hpp>
 #include <tdzdd/spec/SizeConstraint.hpp>
+#include <tdzdd/util/EdgeOrderOptimizer.hpp>
 #include <tdzdd/util/Graph.hpp>
 
 #ifdef SAPPORO
@@ -52,6 +53,8 @@ std::string options[][2] = { //
         {"slow", "Use slower algorithm (only for paths/cycles)"}, //
         {"nola", "Do not use lookahead (only for paths/cycles)"}, //
         {"p", "Use parallel algorithms"}, //
+        {"order", "Optimize the edge order"}, //
+        {"compact", "Use compact states (only for cc/forest)"}, //
         {"dc", "Use degree constraint filter"}, //
         {"nored", "Do not execute final reduction"}, //
         {"ub <n>", "Upper bound of the number of items"}, //
@@ -170,6 +173,8 @@ int main(int argc, char *argv[]) {
             graph.setDefaultPathColor();
         }
 
+        if (opt["order"]) EdgeOrderOptimizer::apply(graph);
+
         m0 << "\n#vertex = " << graph.vertexSize() << ", #edge = "
            << graph.edgeSize() << ", max_frontier_size = "
            << graph.maxFrontierSize();
@@ -196,6 +201,7 @@ int main(int argc, char *argv[]) {
 
         int const n = graph.edgeSize();
         DdStructure<2> f(n);
+        bool universal = true;
 
         MessageHandler m1;
         m1.begin("building") << " ...";
@@ -217,13 +223,19 @@ int main(int argc, char *argv[]) {
             //f.zddSubset(dc, opt["p"]);
             f = DdStructure<2>(dc, opt["p"]);
             f.zddReduce();
+            universal = false;
         }
 
         if (opt["lb"] || opt["ub"]) {
             IntRange r(optNum["lb"], optNum["ub"]);
-            SizeConstraint sc(graph.edgeSize(), &r);
-            f.zddSubset(sc);
-            f.zddReduce();
+            if (universal) {
+                f = DdStructure<2>(n, r);
+            }
+            else {
+                SizeConstraint sc(graph.edgeSize(), &r);
+                f.zddSubset(sc);
+                f.zddReduce();
+            }
         }
 
         if (opt["zdd1"]) f.dumpDot(std::cout, "Intermediate ZDD");
@@ -308,7 +320,7 @@ int main(int argc, char *argv[]) {
         }
         else if (optStr["t"] == "cc" || optStr["t"] == "forest") {
             FrontierBasedSearch fbs(graph, optNum["uec"],
-                    optStr["t"] == "forest");
+                    optStr["t"] == "forest", true, opt["compact"]);
             if (opt["lb"] || opt["ub"]) {
 //                f.zddSubset(fbs, opt["p"]);
                 DdStructure<2> g = f;
@@ -0,0 +1,74 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <tdzdd/DdSpec.hpp>
+
+/**
+ * ZDD spec of the k-combinations of n items.
+ */
+class Combination: public tdzdd::DdSpec<Combination,int,2> {
+    int const n;
+    int const k;
+
+public:
+    Combination(int n, int k)
+            : n(n), k(k) {
+    }
+
+    int getRoot(int& state) const {
+        state = 0;
+        return n;
+    }
+
+    int getChild(int& state, int level, int value) const {
+        state += value;
+        if (--level == 0) return (state == k) ? -1 : 0;
+        if (state > k) return 0;
+        if (state + level < k) return 0;
+        return level;
+    }
+};
+
+/**
+ * ZDD spec that chooses at most one item from each pair of items.
+ */
+template<int N>
+class GroupChoice: public tdzdd::FixedPodArrayDdSpec<GroupChoice<N>,size_t,N,2> {
+public:
+    int getRoot(size_t* count) const {
+        for (int i = 0; i < N; ++i) {
+            count[i] = 0;
+        }
+        return 2 * N;
+    }
+
+    int getChild(size_t* count, int level, int value) const {
+        int const i = (level - 1) / 2;
+        count[i] += value;
+        if (count[i] > 1) return 0;
+        return (--level == 0) ? -1 : level;
+    }
+};
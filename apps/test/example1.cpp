@@ -25,30 +25,9 @@
 #include <gtest/gtest.h>
 #include <tdzdd/DdStructure.hpp>
 
-extern bool useMP;
-
-class Combination: public tdzdd::DdSpec<Combination,int,2> {
-    int const n;
-    int const k;
-
-public:
-    Combination(int n, int k)
-            : n(n), k(k) {
-    }
+#include "Combination.hpp"
 
-    int getRoot(int& state) const {
-        state = 0;
-        return n;
-    }
-
-    int getChild(int& state, int level, int value) const {
-        state += value;
-        if (--level == 0) return (state == k) ? -1 : 0;
-        if (state > k) return 0;
-        if (state + level < k) return 0;
-        return level;
-    }
-};
+extern bool useMP;
 
 using namespace tdzdd;
 
@@ -0,0 +1,138 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdSpecOp.hpp>
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/eval/MaxWeight.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+class Knapsack: public tdzdd::DdSpec<Knapsack,int,2> {
+    std::vector<int> const& sizes;
+    int const capacity;
+
+public:
+    Knapsack(std::vector<int> const& sizes, int capacity)
+            : sizes(sizes), capacity(capacity) {
+    }
+
+    int getRoot(int& used) const {
+        used = 0;
+        return sizes.size() - 1;
+    }
+
+    int getChild(int& used, int level, int value) const {
+        if (value) used += sizes[level];
+        if (used > capacity) return 0;
+        return (--level == 0) ? -1 : level;
+    }
+
+    int relaxStates(int& used1, int& used2, int level) const {
+        used1 = std::min(used1, used2);
+        return 0;
+    }
+};
+
+TEST(BoundedWidthTest, Knapsack) {
+    int const n = 24;
+    std::vector<int> sizes(n + 1);
+    std::vector<int> values(n + 1);
+    for (int i = 1; i <= n; ++i) {
+        sizes[i] = i * 37 % 17 + 3;
+        values[i] = i * 53 % 23 + 1;
+    }
+    std::vector<double> weights(values.begin(), values.end());
+    Knapsack spec(sizes, 60);
+
+    DdStructure<2> dd0(spec, useMP);
+    dd0.zddReduce();
+    int opt = dd0.evaluate(ZddMaxWeight<int>(values));
+
+    for (size_t w = 1; w <= 64; w *= 4) {
+        DdStructure<2> dd1(spec, w, false, weights);
+        ASSERT_LE(dd1.size(), n * w);
+        dd1.zddReduce();
+        int lower = dd1.evaluate(ZddMaxWeight<int>(values));
+        ASSERT_NE(ZddMaxWeight<int>::noSolution(), lower);
+        ASSERT_LE(lower, opt);
+        DdStructure<2> tmp1 = dd1;
+        tmp1.zddSubset(dd0);
+        tmp1.zddReduce();
+        ASSERT_TRUE(tmp1 == dd1);
+
+        DdStructure<2> dd2(spec, w, true, weights);
+        ASSERT_LE(dd2.size(), n * w);
+        dd2.zddReduce();
+        int upper = dd2.evaluate(ZddMaxWeight<int>(values));
+        ASSERT_LE(opt, upper);
+        DdStructure<2> tmp2 = dd0;
+        tmp2.zddSubset(dd2);
+        tmp2.zddReduce();
+        ASSERT_TRUE(tmp2 == dd0);
+    }
+
+    DdStructure<2> dd3(spec, 100000, false);
+    dd3.zddReduce();
+    ASSERT_TRUE(dd3 == dd0);
+    DdStructure<2> dd4(spec, 100000, true);
+    dd4.zddReduce();
+    ASSERT_TRUE(dd4 == dd0);
+
+    ASSERT_THROW(DdStructure<2>(Combination(10, 5), 2, true),
+            std::runtime_error);
+}
+
+TEST(BoundedWidthTest, RelaxedIntersection) {
+    int const n = 20;
+    std::vector<int> sizes1(n + 1);
+    std::vector<int> sizes2(n + 1);
+    for (int i = 1; i <= n; ++i) {
+        sizes1[i] = i * 37 % 17 + 3;
+        sizes2[i] = i * 29 % 13 + 2;
+    }
+    ZddIntersection<Knapsack,Knapsack> spec(Knapsack(sizes1, 50),
+            Knapsack(sizes2, 40));
+
+    DdStructure<2> dd0(spec, useMP);
+    dd0.zddReduce();
+
+    for (size_t w = 1; w <= 16; w *= 4) {
+        DdStructure<2> dd1(spec, w, true);
+        ASSERT_LE(dd1.size(), n * w);
+        dd1.zddReduce();
+        DdStructure<2> tmp = dd0;
+        tmp.zddSubset(dd1);
+        tmp.zddReduce();
+        ASSERT_TRUE(tmp == dd0);
+    }
+}
@@ -0,0 +1,73 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/util/CPUAffinity.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+class CPUAffinityTest: public testing::Test {
+protected:
+    void TearDown() {
+        CPUAffinity::enable(false);
+    }
+};
+
+TEST_F(CPUAffinityTest, BindAndRestore) {
+    DdStructure<2> dd0(GroupChoice<6>(), true);
+    dd0.zddSubset(Combination(12, 4));
+    dd0.zddReduce();
+
+#ifdef __linux__
+    cpu_set_t before;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(before), &before));
+#endif
+    CPUAffinity::enable();
+    ASSERT_LE(1, CPUAffinity::numNodes());
+    ASSERT_GT(CPUAffinity::numNodes(), CPUAffinity::currentNode());
+    DdStructure<2> dd1(GroupChoice<6>(), true);
+    dd1.zddSubset(Combination(12, 4));
+    dd1.zddReduce();
+#ifdef __linux__
+    cpu_set_t after;
+    ASSERT_EQ(0, sched_getaffinity(0, sizeof(after), &after));
+    ASSERT_TRUE(CPU_EQUAL(&before, &after));
+#endif
+    CPUAffinity::enable(false);
+    ASSERT_TRUE(dd0 == dd1);
+
+    std::vector<uint64_t> bytes = CPUAffinity::memoryPerNode();
+    uint64_t total = 0;
+    for (size_t k = 0; k < bytes.size(); ++k) {
+        total += bytes[k];
+    }
+    ASSERT_TRUE(bytes.empty() || total > 0);
+}
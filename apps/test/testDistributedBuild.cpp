@@ -0,0 +1,49 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(DistributedBuildTest, LocalTransport) {
+    DdStructure<2> dd0(Combination(14, 6), useMP);
+    dd0.zddReduce();
+    DdStructure<2> gc0(GroupChoice<5>(), useMP);
+    gc0.zddReduce();
+
+    for (int p = 1; p <= 4; ++p) {
+        LocalTransport lt(p);
+        DdStructure<2> dd1(Combination(14, 6), lt);
+        dd1.zddReduce();
+        ASSERT_TRUE(dd0 == dd1);
+        DdStructure<2> gc1(GroupChoice<5>(), lt);
+        gc1.zddReduce();
+        ASSERT_TRUE(gc0 == gc1);
+    }
+}
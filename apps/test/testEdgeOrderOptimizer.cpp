@@ -0,0 +1,61 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <tdzdd/util/EdgeOrderOptimizer.hpp>
+#include <tdzdd/util/Graph.hpp>
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(EdgeOrderOptimizerTest, Grid) {
+    int const n = 5;
+    Graph g;
+    for (int k = 0; k < n * n; ++k) {
+        int v = (k * 7) % (n * n); // scrambled grid
+        int i = v / n, j = v % n;
+        std::ostringstream s, s1, s2;
+        s << v;
+        s1 << v + 1;
+        s2 << v + n;
+        if (j + 1 < n) g.addEdge(s.str(), s1.str());
+        if (i + 1 < n) g.addEdge(s2.str(), s.str());
+    }
+    g.update();
+    int const m = g.edgeSize();
+    int const before = g.maxFrontierSize();
+
+    EdgeOrderOptimizer opt(g);
+    ASSERT_EQ(before, opt.maxFrontierSize());
+    opt.optimize();
+    ASSERT_GT(before, opt.maxFrontierSize());
+    g.reorderEdges(opt.edgeOrder());
+    ASSERT_EQ(m, g.edgeSize());
+    ASSERT_EQ(opt.maxFrontierSize(), g.maxFrontierSize());
+    ASSERT_LE(g.maxFrontierSize(), n + 2);
+    ASSERT_NO_THROW(g.getEdge("0", "1"));
+}
@@ -0,0 +1,45 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(FixedPodArrayDdSpecTest, GroupChoice) {
+    GroupChoice<3> small;
+    ASSERT_EQ(int(3 * sizeof(size_t)), small.datasize());
+    DdStructure<2> dd(small, useMP);
+    dd.zddReduce();
+    ASSERT_EQ(27, dd.evaluate(ZddCardinality<uint64_t>()));
+
+    DdStructure<2> dd20(GroupChoice<20>(), useMP);
+    dd20.zddReduce();
+    ASSERT_EQ(3486784401ULL, dd20.evaluate(ZddCardinality<uint64_t>()));
+    ASSERT_EQ(40U, dd20.size());
+}
@@ -0,0 +1,64 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/spec/FrontierBasedSearch.hpp>
+#include <tdzdd/util/Graph.hpp>
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(FrontierBasedSearchTest, Compact) {
+    int const n = 4;
+    Graph g;
+    for (int v = 0; v < n * n; ++v) {
+        std::ostringstream s, s1, s2;
+        s << v;
+        s1 << v + 1;
+        s2 << v + n;
+        if (v % n + 1 < n) g.addEdge(s.str(), s1.str());
+        if (v + n < n * n) g.addEdge(s.str(), s2.str());
+    }
+    g.setColor("0", 1);
+    g.setColor("15", 1);
+    g.update();
+
+    for (int k = 0; k < 6; ++k) {
+        int const uec = k / 2 - 1;
+        bool const noLoop = k % 2;
+        FrontierBasedSearch f(g, uec, noLoop);
+        FrontierBasedSearch c(g, uec, noLoop, true, true);
+        ASSERT_GT(f.datasize(), c.datasize());
+        DdStructure<2> df(f, useMP);
+        DdStructure<2> dc(c, useMP);
+        ASSERT_EQ(df.size(), dc.size());
+        df.zddReduce();
+        dc.zddReduce();
+        ASSERT_EQ(df.zddCardinality(), dc.zddCardinality());
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <tdzdd/util/Graph.hpp>
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(GraphTest, Cache) {
+    char const* file = "testGraph.tmp";
+    {
+        std::ofstream ofs(file);
+        ofs << "a b\nb 3\n3 a\r\n  3\t10 \nb a\n10 b\n";
+    }
+    Graph g;
+    g.readEdges(file);
+    g.setColor("a", 0);
+    g.setColor("10", 0);
+    g.update();
+    ASSERT_EQ(4, g.vertexSize());
+    ASSERT_EQ(5, g.edgeSize());
+    ASSERT_EQ(g.getEdge("a", "b"), g.getEdge("b", "a"));
+    ASSERT_THROW(g.getEdge("a", "10"), std::runtime_error);
+
+    g.writeCache(file);
+    Graph h;
+    h.readCache(file);
+    std::remove(file);
+    std::ostringstream os1, os2;
+    for (Graph::EdgeNumber a = 0; a < g.edgeSize(); ++a) {
+        os1 << g.edgeInfo(a) << " " << g.edgeLabel(a) << "\n";
+        os2 << h.edgeInfo(a) << " " << h.edgeLabel(a) << "\n";
+    }
+    ASSERT_EQ(os1.str(), os2.str());
+    ASSERT_EQ(g.getVertex("10"), h.getVertex("10"));
+    ASSERT_EQ(g.getEdge("3", "a"), h.getEdge("a", "3"));
+    ASSERT_EQ(g.numColor(), h.numColor());
+    ASSERT_EQ(g.colorNumber(1), h.colorNumber(1));
+}
@@ -0,0 +1,158 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <map>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/spec/LinearConstraints.hpp>
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(LinearConstraintsTest, TwoConstraints) {
+    int const n = 14;
+    std::map<int,long> e1, e2;
+    for (int i = 1; i <= n; ++i) {
+        e1[i] = (i * 7919L) % 10007 * 100;
+        e2[i] = (i % 3 == 0) ? -i * 1000L : i * 333L;
+    }
+
+    LinearConstraints<long> lc(n);
+    lc.addConstraint(e1, 100000, 300000);
+    lc.addConstraint(e2, -5000, 20000);
+    lc.update();
+    DdStructure<2> dd(lc, useMP);
+    size_t raw = dd.size();
+    dd.zddReduce();
+    ASSERT_GE(raw, dd.size());
+
+    uint64_t count = 0;
+    for (int s = 0; s < (1 << n); ++s) {
+        long v1 = 0, v2 = 0;
+        for (int i = 1; i <= n; ++i) {
+            if (s & (1 << (i - 1))) {
+                v1 += e1[i];
+                v2 += e2[i];
+            }
+        }
+        if (100000 <= v1 && v1 <= 300000 && -5000 <= v2 && v2 <= 20000)
+            ++count;
+    }
+    ASSERT_LT(0U, count);
+    ASSERT_EQ(count, dd.evaluate(ZddCardinality<uint64_t>()));
+
+    std::map<int,double> d1, d2;
+    for (int i = 1; i <= n; ++i) {
+        d1[i] = e1[i];
+        d2[i] = e2[i];
+    }
+    LinearConstraints<double> lcd(n);
+    lcd.addConstraint(d1, 100000, 300000);
+    lcd.addConstraint(d2, -5000, 20000);
+    lcd.update();
+    DdStructure<2> ddd(lcd, useMP);
+    ddd.zddReduce();
+    ASSERT_EQ(count, ddd.evaluate(ZddCardinality<uint64_t>()));
+}
+
+TEST(LinearConstraintsTest, ManyConstraints) {
+    int const n = 16;
+    int const m = 40;
+    std::vector<std::map<int,int> > exprs(m);
+    std::vector<int> lbs(m), ubs(m);
+    for (int c = 0; c < m; ++c) {
+        int s = 1 + (c * 7) % (n - 4);
+        int total = 0;
+        for (int i = s; i < s + 5; ++i) {
+            int w = (c * 31 + i * 17) % 23 + 1;
+            if ((c + i) % 4 == 0) w = -w;
+            exprs[c][i] = w;
+            if (w > 0) total += w;
+        }
+        lbs[c] = -10 - c % 3;
+        ubs[c] = total * 2 / 3;
+    }
+
+    LinearConstraints<int> lc(n);
+    for (int c = 0; c < m; ++c) {
+        lc.addConstraint(exprs[c], lbs[c], ubs[c]);
+    }
+    lc.update();
+    DdStructure<2> dd(lc, useMP);
+    dd.zddReduce();
+
+    uint64_t count = 0;
+    for (int s = 0; s < (1 << n); ++s) {
+        bool ok = true;
+        for (int c = 0; ok && c < m; ++c) {
+            int v = 0;
+            for (std::map<int,int>::const_iterator t = exprs[c].begin();
+                    t != exprs[c].end(); ++t) {
+                if (s & (1 << (t->first - 1))) v += t->second;
+            }
+            ok = lbs[c] <= v && v <= ubs[c];
+        }
+        if (ok) ++count;
+    }
+    ASSERT_LT(0U, count);
+    ASSERT_EQ(count, dd.evaluate(ZddCardinality<uint64_t>()));
+}
+
+TEST(LinearConstraintsTest, FutureSumBudget) {
+    int const n = 8000;
+    std::map<int,int> e;
+    for (int i = 1; i <= n; ++i) {
+        e[i] = i % 10 + 1;
+    }
+    LinearConstraints<int> big(n);
+    big.addConstraint(e, 2 * n, 2 * n + 10);
+    big.update();
+    ASSERT_LT(0U, big.numFutureSums());
+    ASSERT_GE(LinearConstraints<int>::MAX_TOTAL_FUTURE_SUMS,
+            big.numFutureSums());
+
+    int const m = 700; // the budget runs out before the last items
+    e.erase(e.find(m + 1), e.end());
+    LinearConstraints<int> lc(m);
+    lc.addConstraint(e, 2 * m, 2 * m + 10);
+    lc.update();
+    DdStructure<2> dd(lc, useMP);
+    dd.zddReduce();
+
+    std::vector<uint64_t> c(2 * m + 11);
+    c[0] = 1;
+    for (int i = 1; i <= m; ++i) {
+        for (int v = 2 * m + 10; v >= e[i]; --v) {
+            c[v] += c[v - e[i]];
+        }
+    }
+    uint64_t count = 0;
+    for (int v = 2 * m; v <= 2 * m + 10; ++v) {
+        count += c[v];
+    }
+    ASSERT_EQ(count, dd.evaluate(ZddCardinality<uint64_t>()));
+}
@@ -0,0 +1,100 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/util/MemoryAccounting.hpp>
+#include <tdzdd/util/MemoryPool.hpp>
+#include <tdzdd/util/MyList.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+class MemoryAccountingTest: public testing::Test {
+protected:
+    void TearDown() {
+        MemoryAccounting::enable(false);
+    }
+};
+
+TEST_F(MemoryAccountingTest, Operations) {
+    MemoryAccounting::enable();
+    MemoryAccounting::Counter before[MemoryAccounting::NUM_KINDS];
+    for (int k = 0; k < MemoryAccounting::NUM_KINDS; ++k) {
+        before[k] = MemoryAccounting::get(MemoryAccounting::Kind(k));
+    }
+
+    {
+        DdStructure<2> dd(Combination(20, 10), useMP);
+        dd.zddReduce();
+        ASSERT_EQ(184756, dd.evaluate(ZddCardinality<uint64_t>()));
+        dd.zddSubset(Combination(20, 10));
+        ASSERT_LT(before[MemoryAccounting::ROWS].live,
+                MemoryAccounting::get(MemoryAccounting::ROWS).live);
+        ASSERT_LT(before[MemoryAccounting::HASH].total,
+                MemoryAccounting::get(MemoryAccounting::HASH).total);
+    }
+
+    MemoryAccounting::enable(false);
+    for (int k = 0; k < MemoryAccounting::NUM_KINDS; ++k) {
+        MemoryAccounting::Counter c =
+                MemoryAccounting::get(MemoryAccounting::Kind(k));
+        ASSERT_EQ(before[k].live, c.live);
+        ASSERT_LE(before[k].live, c.peak);
+    }
+    ASSERT_LT(before[MemoryAccounting::LIST].total,
+            MemoryAccounting::get(MemoryAccounting::LIST).total);
+}
+
+TEST_F(MemoryAccountingTest, ToggledBlocks) {
+    // blocks made while accounting is off are not charged on release
+    MemoryAccounting::Counter list0 =
+            MemoryAccounting::get(MemoryAccounting::LIST);
+    MemoryAccounting::Counter pool0 =
+            MemoryAccounting::get(MemoryAccounting::POOL);
+    {
+        MyList<int> list;
+        MemoryPool pool;
+        list.alloc_front();
+        pool.allocate<int>();
+        MemoryAccounting::enable();
+        list.alloc_front();
+    }
+    ASSERT_EQ(list0.live, MemoryAccounting::get(MemoryAccounting::LIST).live);
+    ASSERT_EQ(pool0.live, MemoryAccounting::get(MemoryAccounting::POOL).live);
+
+    // blocks made while accounting is on are charged on release
+    {
+        MyList<int> list;
+        MemoryPool pool;
+        list.alloc_front();
+        pool.allocate<int>();
+        MemoryAccounting::enable(false);
+    }
+    ASSERT_EQ(list0.live, MemoryAccounting::get(MemoryAccounting::LIST).live);
+    ASSERT_EQ(pool0.live, MemoryAccounting::get(MemoryAccounting::POOL).live);
+}
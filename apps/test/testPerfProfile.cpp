@@ -0,0 +1,63 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/util/PerfCounter.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+class PerfProfileTest: public testing::Test {
+protected:
+    void SetUp() {
+        PerfProfile::clear();
+    }
+
+    void TearDown() {
+        PerfProfile::enable(false);
+        PerfProfile::clear();
+    }
+};
+
+TEST_F(PerfProfileTest, Phases) {
+    PerfProfile::enable();
+    DdStructure<2> dd(Combination(10, 3), useMP);
+    dd.zddReduce();
+    PerfProfile::enable(false);
+    ASSERT_EQ(120, dd.evaluate(ZddCardinality<uint64_t>()));
+
+    std::ostringstream oss;
+    PerfProfile::print(oss);
+    PerfProfile::clear();
+    std::string s = oss.str();
+    ASSERT_NE(std::string::npos, s.find(useMP ? "build.P1" : "build.dedup"));
+    ASSERT_NE(std::string::npos, s.find("reduce"));
+}
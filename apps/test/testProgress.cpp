@@ -0,0 +1,102 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+#include <tdzdd/util/Progress.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+class CancelAfter: public ProgressCallback {
+    int remaining;
+
+public:
+    int calls;
+    double fraction;
+
+    CancelAfter(int levels)
+            : remaining(levels), calls(0), fraction(0) {
+    }
+
+    bool progress(ProgressInfo const& info) {
+        ++calls;
+        fraction = info.fraction();
+        return --remaining != 0;
+    }
+};
+
+class ProgressTest: public testing::Test {
+protected:
+    ProgressCallback* prev;
+
+    void SetUp() {
+        prev = Progress::setCallback(0);
+    }
+
+    void TearDown() {
+        Progress::setCallback(prev);
+    }
+};
+
+TEST_F(ProgressTest, DefaultCallback) {
+    CancelAfter all(-1);
+    Progress::setCallback(&all);
+    DdStructure<2> dd(Combination(10, 3), useMP);
+    dd.zddReduce();
+    ASSERT_EQ(120, dd.evaluate(ZddCardinality<uint64_t>()));
+    ASSERT_EQ(30, all.calls);
+    ASSERT_DOUBLE_EQ(1.0, all.fraction);
+
+    CancelAfter three(3);
+    Progress::setCallback(&three);
+    ASSERT_THROW(DdStructure<2>(Combination(10, 3), useMP), Cancelled);
+    ASSERT_EQ(3, three.calls);
+
+    CancelAfter one(1);
+    Progress::setCallback(&one);
+    DdStructure<2> dd0 = dd;
+    ASSERT_THROW(dd.zddSubset(Combination(10, 3)), Cancelled);
+    ASSERT_TRUE(dd == dd0);
+    ASSERT_EQ(120, dd.evaluate(ZddCardinality<uint64_t>()));
+}
+
+TEST_F(ProgressTest, PerDdCallback) {
+    DdStructure<2> dd(Combination(10, 3), useMP);
+    dd.zddReduce();
+
+    CancelAfter two(2);
+    DdStructure<2> dd1(Combination(10, 3), useMP);
+    DdStructure<2> dd2 = dd1;
+    ASSERT_EQ(0, dd1.setProgressCallback(&two));
+    ASSERT_THROW(dd1.zddReduce(true), Cancelled);
+    ASSERT_EQ(2, two.calls);
+    ASSERT_TRUE(dd1 == dd2);
+    dd1.setProgressCallback(0);
+    dd1.zddReduce(true);
+    ASSERT_TRUE(dd1 == dd);
+}
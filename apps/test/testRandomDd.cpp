@@ -25,6 +25,7 @@
 #include <gtest/gtest.h>
 
 #include <tdzdd/DdStructure.hpp>
+#include <tdzdd/DdSpecOp.hpp>
 
 #include "RandomDd.hpp"
 
@@ -58,6 +59,24 @@ void do_test(int n, int w, double d) {
     zqd.zddSubset(qdd);
     ASSERT_EQ(zdd, zqd);
 
+    DdStructure<A> qip = dd;
+    DdStructure<A> bip = dd;
+    DdStructure<A> zip = dd;
+    qip.qddReduce(true);
+    bip.bddReduce(true);
+    zip.zddReduce(true);
+    ASSERT_LE(qip.size(), qdd.size());
+    ASSERT_EQ(qdd, qip);
+    ASSERT_EQ(bdd, bip);
+    ASSERT_EQ(zdd, zip);
+
+    bip.optimizeLayout();
+    zip.optimizeLayout();
+    ASSERT_EQ(bdd, bip);
+    ASSERT_EQ(zdd, zip);
+    ASSERT_EQ(bdd.bddCardinality(n), bip.bddCardinality(n));
+    ASSERT_EQ(zdd.zddCardinality(), zip.zddCardinality());
+
     DdStructure<A> zbd = bdd.bdd2zdd(n);
     if (bdd != zdd) {
         ASSERT_NE(bdd, zbd);
@@ -69,6 +88,14 @@ void do_test(int n, int w, double d) {
         ASSERT_NE(zdd, bzd);
     }
     ASSERT_EQ(bdd, bzd);
+
+    DdStructure<A> zbm(zddLookahead(bddUnreduction(bdd, n), 16), useMP);
+    zbm.zddReduce();
+    ASSERT_EQ(zdd, zbm);
+
+    DdStructure<A> bzm(bddLookahead(zddUnreduction(zdd, n), 16), useMP);
+    bzm.bddReduce();
+    ASSERT_EQ(bdd, bzm);
 }
 
 TEST(RandomDdTest, Binary) {
@@ -0,0 +1,51 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(ReducedSubsetTest, GroupChoice) {
+    int const n = 12;
+    DdStructure<2> dd0(Combination(n, 5), useMP);
+    dd0.zddSubset(GroupChoice<n / 2>());
+    dd0.zddReduce();
+
+    DdStructure<2> dd1(Combination(n, 5), useMP);
+    ASSERT_FALSE(dd1.useReducedSubset());
+    dd1.zddSubset(GroupChoice<n / 2>());
+    ASSERT_EQ(dd0.size(), dd1.size());
+    ASSERT_TRUE(dd0 == dd1);
+    ASSERT_EQ(dd0.evaluate(ZddCardinality<uint64_t>()),
+            dd1.evaluate(ZddCardinality<uint64_t>()));
+
+    DdStructure<2> dd2(Combination(n, 5), useMP);
+    dd2.zddSubset(GroupChoice<n / 2>());
+    ASSERT_LT(dd0.size(), dd2.size());
+}
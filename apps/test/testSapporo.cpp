@@ -0,0 +1,103 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(SapporoTest, Dump) {
+    DdStructure<2> dd(Combination(4, 2));
+    dd.zddReduce();
+    std::ostringstream oss;
+    dd.dumpSapporo(oss);
+    ASSERT_EQ("_i 4\n_o 1\n_n 6\n"
+              "2 1 F T\n"
+              "4 2 2 T\n"
+              "6 2 F 2\n"
+              "8 3 4 T\n"
+              "10 3 6 4\n"
+              "12 4 10 8\n"
+              "12\n", oss.str());
+
+    DdStructure<2> big(Combination(20, 10));
+    big.zddReduce();
+    std::ostringstream serial, parallel;
+    big.dumpSapporo(serial);
+    big.useMultiProcessors(useMP);
+    big.dumpSapporo(parallel);
+    ASSERT_EQ(serial.str(), parallel.str());
+}
+
+TEST(SapporoTest, Read) {
+    char const* file = "testSapporo.tmp";
+    DdStructure<2> dd(Combination(20, 10));
+    dd.zddReduce();
+    std::ostringstream oss;
+    dd.dumpSapporo(oss);
+    {
+        std::ofstream ofs(file);
+        ofs << oss.str();
+    }
+
+    DdStructure<2> e;
+    e.useMultiProcessors(useMP);
+    e.readSapporo(file);
+    ASSERT_EQ(dd.size(), e.size());
+    ASSERT_EQ(184756, e.evaluate(ZddCardinality<uint64_t>()));
+    std::ostringstream oss2;
+    e.dumpSapporo(oss2);
+    ASSERT_EQ(oss.str(), oss2.str());
+
+    /* {{1},{1,2}} written with complement edges. */
+    {
+        std::ofstream ofs(file);
+        ofs << "_i 2\n_o 1\n_n 2\n2 1 F T\n4 2 3 2\n5\n";
+    }
+    e.readSapporo(file);
+    ASSERT_EQ(2, e.evaluate(ZddCardinality<uint64_t>()));
+
+    {
+        std::ofstream ofs(file);
+        ofs << "4 2 B T\n3 1 4 T\n.\n";
+    }
+    e.readGraphillion(file);
+    ASSERT_EQ(2, e.evaluate(ZddCardinality<uint64_t>()));
+    ASSERT_EQ(2U, e.size());
+
+    {
+        std::ofstream ofs(file);
+        ofs << "_i 1\n2 1 F T\n2 X\n";
+    }
+    ASSERT_THROW(e.readSapporo(file), std::runtime_error);
+    std::remove(file);
+}
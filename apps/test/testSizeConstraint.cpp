@@ -146,3 +146,66 @@ TEST(SizeConstraintTest, ZDD) {
     ASSERT_EQ(3, zr.evaluate(MinNumItems()));
     ASSERT_EQ(9, zr.evaluate(MaxNumItems()));
 }
+
+TEST(SizeConstraintTest, ClosedForm) {
+    IntRange ranges[] = {IntRange(0, 0), IntRange(3, 3), IntRange(0, 4),
+                         IntRange(5), IntRange(2, 10, 3), IntRange(13),
+                         IntRange()};
+
+    for (int n = 1; n <= 12; ++n) {
+        for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); ++r) {
+            DdStructure<2> spec(SizeConstraint(n, ranges[r]), useMP);
+            spec.zddReduce();
+            DdStructure<2> direct(n, ranges[r], useMP);
+            ASSERT_EQ(spec.size(), direct.size());
+            ASSERT_EQ(spec, direct);
+            direct.zddReduce();
+            ASSERT_EQ(spec.size(), direct.size());
+        }
+    }
+    ASSERT_EQ(DdStructure<2>(10), DdStructure<2>(10, IntRange()));
+
+    std::vector<int> groups;
+    groups.push_back(3);
+    groups.push_back(5);
+    groups.push_back(2);
+    DdStructure<2> g(groups, IntRange(1, 2), useMP);
+    ASSERT_EQ((3 + 3) * (5 + 10) * (2 + 1), g.evaluate(ZddCardinality<int>()));
+    ASSERT_EQ(3, g.evaluate(MinNumItems()));
+    ASSERT_EQ(6, g.evaluate(MaxNumItems()));
+    size_t size = g.size();
+    g.zddReduce();
+    ASSERT_EQ(size, g.size());
+
+    DdStructure<2> none(groups, IntRange(4), useMP);
+    ASSERT_EQ(DdStructure<2>(), none);
+}
+
+TEST(SizeConstraintTest, FusedSubset) {
+    IntRange r1(0, 8);
+    IntRange r2(3, 12, 3);
+    IntRange r3(5);
+    DdStructure<2> f(12, IntRange(0, 12, 2), useMP);
+
+    DdStructure<2> seq = f;
+    seq.zddSubset(SizeConstraint(12, r1));
+    seq.zddReduce();
+    seq.zddSubset(SizeConstraint(12, r2));
+    seq.zddReduce();
+    ASSERT_EQ(DdStructure<2>(12, IntRange(6, 6)), seq);
+
+    DdStructure<2> fused = f;
+    fused.zddSubset(SizeConstraint(12, r1), SizeConstraint(12, r2));
+    fused.zddReduce();
+    ASSERT_EQ(seq, fused);
+
+#if __cplusplus >= 201103L
+    seq.zddSubset(SizeConstraint(12, r3));
+    seq.zddReduce();
+    fused = f;
+    fused.zddSubset(SizeConstraint(12, r1), SizeConstraint(12, r2),
+            SizeConstraint(12, r3));
+    fused.zddReduce();
+    ASSERT_EQ(seq, fused);
+#endif
+}
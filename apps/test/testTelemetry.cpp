@@ -0,0 +1,71 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <tdzdd/DdStructure.hpp>
+
+#include "Combination.hpp"
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+class TelemetryTest: public testing::Test {
+protected:
+    std::ostream* prev;
+
+    void SetUp() {
+        prev = Telemetry::setOutput(0);
+    }
+
+    void TearDown() {
+        Telemetry::setOutput(prev);
+    }
+};
+
+TEST_F(TelemetryTest, PerLevelRecords) {
+    std::ostringstream oss;
+    Telemetry::setOutput(&oss, Telemetry::CSV);
+    DdStructure<2> dd(Combination(10, 3), useMP);
+    dd.zddReduce();
+    ASSERT_EQ(120, dd.evaluate(ZddCardinality<uint64_t>()));
+    Telemetry::setOutput(0);
+
+    std::istringstream iss(oss.str());
+    std::string line;
+    int build = 0, reduce = 0, evaluate = 0;
+    ASSERT_TRUE(std::getline(iss, line));
+    ASSERT_EQ(0U, line.find("id,op,name,level,"));
+    while (std::getline(iss, line)) {
+        if (line.find(",build,") != std::string::npos) ++build;
+        if (line.find(",reduce,") != std::string::npos) ++reduce;
+        if (line.find(",evaluate,") != std::string::npos) ++evaluate;
+    }
+    ASSERT_EQ(10, build);
+    ASSERT_EQ(10, reduce);
+    ASSERT_EQ(10, evaluate);
+}
@@ -0,0 +1,51 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <tdzdd/util/WordArray.hpp>
+
+using namespace tdzdd;
+
+extern bool useMP;
+
+TEST(WordArrayTest, EqualAndHash) {
+    std::vector<size_t> a(70), b;
+    for (int i = 0; i < 70; ++i) {
+        a[i] = i * 7919;
+    }
+    b = a;
+
+    for (int n = 1; n <= 70; ++n) {
+        ASSERT_TRUE(WordArray::equal(&a[0], &b[0], n));
+        ASSERT_EQ(WordArray::hash(&a[0], n), WordArray::hash(&b[0], n));
+        for (int i = 0; i < n; ++i) {
+            b[i] ^= 1;
+            ASSERT_FALSE(WordArray::equal(&a[0], &b[0], n));
+            ASSERT_NE(WordArray::hash(&a[0], n), WordArray::hash(&b[0], n));
+            b[i] = a[i];
+        }
+    }
+}
@@ -32,6 +32,7 @@
 #include "dd/DepthFirstSearcher.hpp"
 #include "util/demangle.hpp"
 #include "util/MessageHandler.hpp"
+#include "util/WordArray.hpp"
 
 namespace tdzdd {
 
@@ -53,6 +54,10 @@ namespace tdzdd {
  * Optionally, the following functions can be overloaded:
  * - void printLevel(std::ostream& os, int level) const
  *
+ * The width-bounded builder (DdBuilderBounded) also uses:
+ * - double score_state(void const* p, int level) const
+ * - int relax_states(void* p1, void* p2, int level)
+ *
  * A return code of get_root(void*) or get_child(void*, int, bool) is:
  * 0 when the node is the 0-terminal, -1 when it is the 1-terminal, or
  * the node level when it is a non-terminal.
@@ -60,6 +65,12 @@ namespace tdzdd {
  * merged into the first one, 1 when they cannot be merged and the first
  * one should be forwarded to the 0-terminal, 2 when they cannot be merged
  * and the second one should be forwarded to the 0-terminal.
+ * A score_state(void const*, int) value ranks a state at the given level
+ * in addition to its best path weight; states of higher rank survive
+ * when the level is too wide.
+ * relax_states(void*, void*, int) returns a code in the same way as
+ * merge_states(void*, void*), but the first state after the merge must
+ * admit every completion of both states.
  *
  * @tparam S the class implementing this class.
  * @tparam AR arity of the nodes.
@@ -214,6 +225,14 @@ public:
         return 0;
     }
 
+    double score_state(void const* p, int level) const {
+        return 0;
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        throw std::runtime_error("relax_states is not implemented");
+    }
+
     void destruct(void* p) {
     }
 
@@ -244,6 +263,8 @@ public:
  * - void construct(void* p)
  * - void getCopy(void* p, T const& state)
  * - void mergeStates(T& state1, T& state2)
+ * - double scoreState(T const& state, int level) const
+ * - int relaxStates(T& state1, T& state2, int level)
  * - size_t hashCode(T const& state) const
  * - bool equalTo(T const& state1, T const& state2) const
  * - void printLevel(std::ostream& os, int level) const
@@ -302,6 +323,22 @@ public:
         return this->entity().mergeStates(state(p1), state(p2));
     }
 
+    double scoreState(State const& s, int level) const {
+        return 0;
+    }
+
+    double score_state(void const* p, int level) const {
+        return this->entity().scoreState(state(p), level);
+    }
+
+    int relaxStates(State& s1, State& s2, int level) {
+        throw std::runtime_error("relaxStates is not implemented");
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        return this->entity().relaxStates(state(p1), state(p2), level);
+    }
+
     void destruct(void* p) {
         state(p).~State();
     }
@@ -360,6 +397,8 @@ public:
  *
  * Optionally, the following functions can be overloaded:
  * - void mergeStates(T* array1, T* array2)
+ * - double scoreState(T const* array, int level) const
+ * - int relaxStates(T* array1, T* array2, int level)
  * - size_t hashCode(T const* state) const
  * - bool equalTo(T const* state1, T const* state2) const
  * - void printLevel(std::ostream& os, int level) const
@@ -440,6 +479,22 @@ public:
         return this->entity().mergeStates(state(p1), state(p2));
     }
 
+    double scoreState(T const* a, int level) const {
+        return 0;
+    }
+
+    double score_state(void const* p, int level) const {
+        return this->entity().scoreState(state(p), level);
+    }
+
+    int relaxStates(T* a1, T* a2, int level) {
+        throw std::runtime_error("relaxStates is not implemented");
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        return this->entity().relaxStates(state(p1), state(p2), level);
+    }
+
     void destruct(void* p) {
     }
 
@@ -447,14 +502,150 @@ public:
     }
 
     size_t hashCode(State const* s) const {
-        Word const* pa = reinterpret_cast<Word const*>(s);
-        Word const* pz = pa + dataWords;
-        size_t h = 0;
-        while (pa != pz) {
-            h += *pa++;
-            h *= 314159257;
+        return WordArray::hash(reinterpret_cast<Word const*>(s), dataWords);
+    }
+
+    size_t hashCodeAtLevel(State const* s, int level) const {
+        return this->entity().hashCode(s);
+    }
+
+    size_t hash_code(void const* p, int level) const {
+        return this->entity().hashCodeAtLevel(state(p), level);
+    }
+
+    bool equalTo(State const* s1, State const* s2) const {
+        return WordArray::equal(reinterpret_cast<Word const*>(s1),
+                reinterpret_cast<Word const*>(s2), dataWords);
+    }
+
+    bool equalToAtLevel(State const* s1, State const* s2, int level) const {
+        return this->entity().equalTo(s1, s2);
+    }
+
+    bool equal_to(void const* p, void const* q, int level) const {
+        return this->entity().equalToAtLevel(state(p), state(q), level);
+    }
+
+    void printState(std::ostream& os, State const* a) const {
+        os << "[";
+        for (int i = 0; i < arraySize; ++i) {
+            if (i > 0) os << ",";
+            os << a[i];
         }
-        return h;
+        os << "]";
+    }
+
+    void printStateAtLevel(std::ostream& os, State const* a, int level) const {
+        this->entity().printState(os, a);
+    }
+
+    void print_state(std::ostream& os, void const* p, int level) const {
+        this->entity().printStateAtLevel(os, state(p), level);
+    }
+};
+
+/**
+ * Abstract class of DD specifications using POD array states
+ * of a size fixed at compile time.
+ * It works like PodArrayDdSpec without setArraySize(int n), and lets
+ * the compiler unroll the loops of copying, hashing and comparing states.
+ *
+ * Every implementation must have the following functions:
+ * - int getRoot(T* array)
+ * - int getChild(T* array, int level, int value)
+ *
+ * Optionally, the following functions can be overloaded:
+ * - void mergeStates(T* array1, T* array2)
+ * - double scoreState(T const* array, int level) const
+ * - int relaxStates(T* array1, T* array2, int level)
+ * - size_t hashCode(T const* state) const
+ * - bool equalTo(T const* state1, T const* state2) const
+ * - void printLevel(std::ostream& os, int level) const
+ * - void printState(std::ostream& os, State const* array) const
+ *
+ * @tparam S the class implementing this class.
+ * @tparam T data type of array elements.
+ * @tparam N size of the array.
+ * @tparam AR arity of the nodes.
+ */
+template<typename S, typename T, int N, int AR>
+class FixedPodArrayDdSpec: public DdSpecBase<S,AR> {
+public:
+    typedef T State;
+    static int const ARRAY_SIZE = N;
+
+private:
+    typedef size_t Word;
+    static int const DATA_WORDS = (N * sizeof(State) + sizeof(Word) - 1)
+            / sizeof(Word);
+
+    static State* state(void* p) {
+        return static_cast<State*>(p);
+    }
+
+    static State const* state(void const* p) {
+        return static_cast<State const*>(p);
+    }
+
+protected:
+    int getArraySize() const {
+        return N;
+    }
+
+public:
+    int datasize() const {
+        return DATA_WORDS * sizeof(Word);
+    }
+
+    int get_root(void* p) {
+        return this->entity().getRoot(state(p));
+    }
+
+    int get_child(void* p, int level, int value) {
+        assert(0 <= value && value < S::ARITY);
+        return this->entity().getChild(state(p), level, value);
+    }
+
+    void get_copy(void* to, void const* from) {
+        Word const* pa = static_cast<Word const*>(from);
+        Word* qa = static_cast<Word*>(to);
+        for (int i = 0; i < DATA_WORDS; ++i) {
+            qa[i] = pa[i];
+        }
+    }
+
+    int mergeStates(T* a1, T* a2) {
+        return 0;
+    }
+
+    int merge_states(void* p1, void* p2) {
+        return this->entity().mergeStates(state(p1), state(p2));
+    }
+
+    double scoreState(T const* a, int level) const {
+        return 0;
+    }
+
+    double score_state(void const* p, int level) const {
+        return this->entity().scoreState(state(p), level);
+    }
+
+    int relaxStates(T* a1, T* a2, int level) {
+        throw std::runtime_error("relaxStates is not implemented");
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        return this->entity().relaxStates(state(p1), state(p2), level);
+    }
+
+    void destruct(void* p) {
+    }
+
+    void destructLevel(int level) {
+    }
+
+    size_t hashCode(State const* s) const {
+        return WordArray::hash(reinterpret_cast<Word const*>(s), DATA_WORDS);
     }
 
     size_t hashCodeAtLevel(State const* s, int level) const {
@@ -468,9 +659,11 @@ public:
     bool equalTo(State const* s1, State const* s2) const {
         Word const* pa = reinterpret_cast<Word const*>(s1);
         Word const* qa = reinterpret_cast<Word const*>(s2);
-        Word const* pz = pa + dataWords;
-        while (pa != pz) {
-            if (*pa++ != *qa++) return false;
+        if (DATA_WORDS >= WordArray::SIMD_WORDS) {
+            return WordArray::equal(pa, qa, DATA_WORDS);
+        }
+        for (int i = 0; i < DATA_WORDS; ++i) {
+            if (pa[i] != qa[i]) return false;
         }
         return true;
     }
@@ -485,7 +678,7 @@ public:
 
     void printState(std::ostream& os, State const* a) const {
         os << "[";
-        for (int i = 0; i < arraySize; ++i) {
+        for (int i = 0; i < N; ++i) {
             if (i > 0) os << ",";
             os << a[i];
         }
@@ -512,6 +705,8 @@ public:
  * - void construct(void* p)
  * - void getCopy(void* p, TS const& state)
  * - void mergeStates(TS& s1, TA* a1, TS& s2, TA* a2)
+ * - double scoreState(TS const& s, TA const* a, int level) const
+ * - int relaxStates(TS& s1, TA* a1, TS& s2, TA* a2, int level)
  * - size_t hashCode(TS const& state) const
  * - bool equalTo(TS const& state1, TS const& state2) const
  * - void printLevel(std::ostream& os, int level) const
@@ -613,6 +808,24 @@ public:
                                           a_state(p2));
     }
 
+    double scoreState(S_State const& s, A_State const* a, int level) const {
+        return 0;
+    }
+
+    double score_state(void const* p, int level) const {
+        return this->entity().scoreState(s_state(p), a_state(p), level);
+    }
+
+    int relaxStates(S_State& s1, A_State* a1, S_State& s2, A_State* a2,
+            int level) {
+        throw std::runtime_error("relaxStates is not implemented");
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        return this->entity().relaxStates(s_state(p1), a_state(p1),
+                                          s_state(p2), a_state(p2), level);
+    }
+
     void destruct(void* p) {
     }
 
@@ -637,7 +850,7 @@ public:
             h += *pa++;
             h *= 314159257;
         }
-        return h;
+        return h ^ (h >> (sizeof(h) * 4)); // spread small packed words
     }
 
     bool equalTo(S_State const& s1, S_State const& s2) const {
@@ -129,21 +129,25 @@ ZddUnion<SS...> zddUnion(SS const&... specs) {
 /**
  * Optimizes a BDD specification in terms of the BDD node deletion rule.
  * @param spec original BDD specification.
+ * @param memoSize the number of cached lookahead results for each level;
+ *        0 to disable the cache.
  * @return optimized BDD specification.
  */
 template<typename S>
-BddLookahead<S> bddLookahead(S const& spec) {
-    return BddLookahead<S>(spec);
+BddLookahead<S> bddLookahead(S const& spec, size_t memoSize = 0) {
+    return BddLookahead<S>(spec, memoSize);
 }
 
 /**
  * Optimizes a ZDD specification in terms of the ZDD node deletion rule.
  * @param spec original ZDD specification.
+ * @param memoSize the number of cached lookahead results for each level;
+ *        0 to disable the cache.
  * @return optimized ZDD specification.
  */
 template<typename S>
-ZddLookahead<S> zddLookahead(S const& spec) {
-    return ZddLookahead<S>(spec);
+ZddLookahead<S> zddLookahead(S const& spec, size_t memoSize = 0) {
+    return ZddLookahead<S>(spec, memoSize);
 }
 
 /**
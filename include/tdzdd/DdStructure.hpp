@@ -30,21 +30,31 @@
 #include <ostream>
 #include <set>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "DdEval.hpp"
 #include "DdSpec.hpp"
 #include "dd/DdBuilder.hpp"
+#include "dd/DdBuilderDist.hpp"
+#include "dd/DdConverter.hpp"
 #include "dd/DdReducer.hpp"
 #include "dd/Node.hpp"
 #include "dd/NodeTable.hpp"
+#include "dd/ZddImporter.hpp"
 #include "eval/Cardinality.hpp"
+#include "op/BinaryOperation.hpp"
 #include "op/Lookahead.hpp"
 #include "op/Unreduction.hpp"
 #include "util/demangle.hpp"
+#include "util/IntSubset.hpp"
+#include "util/MappedFile.hpp"
 #include "util/MessageHandler.hpp"
 #include "util/MyHashTable.hpp"
 #include "util/MyVector.hpp"
+#include "util/OutputBuffer.hpp"
+#include "util/Progress.hpp"
+#include "util/Telemetry.hpp"
 
 namespace tdzdd {
 
@@ -57,13 +67,15 @@ class DdStructure: public DdSpec<DdStructure<ARITY>,NodeId,ARITY> {
     NodeTableHandler<ARITY> diagram; ///< The diagram structure.
     NodeId root_;                    ///< Root node ID.
     bool useMP;                      ///< Flag to use MP algorithms.
+    bool reducedSubset;              ///< Flag to reduce the subset results.
+    ProgressCallback* progress_;     ///< Progress callback or null.
 
 public:
     /**
      * Default constructor.
      */
     DdStructure() :
-            root_(0), useMP(false) {
+            root_(0), useMP(false), reducedSubset(false), progress_(0) {
     }
 
 //    /*
@@ -80,7 +92,8 @@ public:
      * @param useMP use algorithms for multiple processors.
      */
     DdStructure(int n, bool useMP = false) :
-            diagram(n + 1), root_(1), useMP(useMP) {
+            diagram(n + 1), root_(1), useMP(useMP), reducedSubset(false),
+            progress_(0) {
         assert(n >= 0);
         NodeTableEntity<ARITY>& table = diagram.privateEntity();
         NodeId f(1);
@@ -96,6 +109,49 @@ public:
         root_ = f;
     }
 
+    /**
+     * Cardinality-constrained ZDD constructor.
+     * It directly writes the reduced ZDD of the subsets of n variables
+     * whose sizes are in a given set.
+     * IntRange(k, k), IntRange(0, k) and IntRange(k) give exactly,
+     * at most and at least k of n, respectively.
+     * @param n the number of variables.
+     * @param sizes the set of allowed sizes.
+     * @param useMP use algorithms for multiple processors.
+     */
+    DdStructure(int n, IntSubset const& sizes, bool useMP = false) :
+            diagram(n + 1), root_(1), useMP(useMP), reducedSubset(false),
+            progress_(0) {
+        assert(n >= 0);
+        root_ = constructSizes_(0, n, sizes, root_);
+    }
+
+    /**
+     * Group-wise cardinality-constrained ZDD constructor.
+     * The variables are split into consecutive groups from the top level
+     * and it directly writes the reduced ZDD of the subsets that have
+     * a number of variables in a given set from every group.
+     * @param groups the numbers of variables of the groups from the top.
+     * @param sizes the set of allowed sizes in each group.
+     * @param useMP use algorithms for multiple processors.
+     */
+    DdStructure(std::vector<int> const& groups, IntSubset const& sizes,
+            bool useMP = false) :
+            root_(1), useMP(useMP), reducedSubset(false), progress_(0) {
+        int n = 0;
+        for (size_t g = 0; g < groups.size(); ++g) {
+            assert(groups[g] >= 0);
+            n += groups[g];
+        }
+        diagram.init(n + 1);
+
+        int base = 0;
+        for (size_t g = groups.size(); g-- > 0;) {
+            root_ = constructSizes_(base, groups[g], sizes, root_);
+            base += groups[g];
+        }
+    }
+
     /**
      * DD construction.
      * @param spec DD spec.
@@ -103,7 +159,7 @@ public:
      */
     template<typename SPEC>
     DdStructure(DdSpecBase<SPEC,ARITY> const& spec, bool useMP = false) :
-            useMP(useMP) {
+            useMP(useMP), reducedSubset(false), progress_(0) {
 #ifdef _OPENMP
         if (useMP) constructMP_(spec.entity());
         else
@@ -111,18 +167,269 @@ public:
         construct_(spec.entity());
     }
 
+    /**
+     * DD construction with a bounded number of nodes in each level.
+     * When a level is too wide, its nodes are ranked by the weight of
+     * their heaviest path from the root plus the spec's scoreState.
+     * A restricted DD forwards the lowest-ranked nodes to the 0-terminal
+     * and represents a subfamily of the exact one; a relaxed DD merges
+     * them into one node by the spec's relaxStates and represents
+     * a superfamily.
+     * Evaluating the weights on both of them gives a primal and a dual
+     * bound of the optimum.
+     * @param spec DD spec.
+     * @param maxWidth the maximum number of nodes in a level.
+     * @param relaxed make a relaxed DD instead of a restricted one.
+     * @param weights the weight of each level for ranking the nodes.
+     */
+    template<typename SPEC>
+    DdStructure(DdSpecBase<SPEC,ARITY> const& spec, size_t maxWidth,
+            bool relaxed,
+            std::vector<double> const& weights = std::vector<double>()) :
+            useMP(false), reducedSubset(false), progress_(0) {
+        MessageHandler mh;
+        mh.begin(typenameof(spec.entity()));
+        mh << (relaxed ? " relaxed " : " restricted ") << maxWidth;
+        Telemetry tm("build", Telemetry::nameOf(spec.entity()));
+        DdBuilderBounded<SPEC> zc(spec.entity(), diagram, maxWidth, relaxed,
+                weights);
+        int n = zc.initialize(root_);
+        Progress pg("build", n);
+
+        if (n > 0) {
+            mh.setSteps(n);
+            for (int i = n; i > 0; --i) {
+                zc.construct(i);
+                tm.record(i, zc.levelStats());
+                if (!pg.report(i, zc.levelStats())) {
+                    zc.destructPending(i);
+                    cancel_("build");
+                }
+                mh.step();
+            }
+        }
+        else {
+            mh << " ...";
+        }
+
+        mh.end(size());
+    }
+
+    /**
+     * DD construction distributed over processes.
+     * Every process calls this with the same spec and its own transport.
+     * The states of each level are partitioned among the processes,
+     * and the result is gathered on rank 0 while the others get
+     * the 0-terminal.
+     * The states must not own memory since they are copied byte-wise.
+     * @param spec DD spec.
+     * @param transport the transport of this process.
+     */
+    template<typename SPEC>
+    DdStructure(DdSpecBase<SPEC,ARITY> const& spec, DdTransport& transport) :
+            root_(0), useMP(false), reducedSubset(false), progress_(0) {
+        MessageHandler mh;
+        mh.begin(typenameof(spec.entity()));
+        mh << " " << transport.rank() << "/" << transport.size();
+        Telemetry tm("build", Telemetry::nameOf(spec.entity()));
+        DdBuilderDist<SPEC> zc(spec.entity(), transport);
+        int n = zc.initialize();
+
+        mh.setSteps(n);
+        for (int i = n; i > 0; --i) {
+            zc.construct(i);
+            zc.collect();
+            tm.record(i, zc.levelStats());
+            mh.step();
+        }
+
+        diagram = NodeTableHandler<ARITY>(n + 1);
+        for (int i = 1; i <= n; ++i) {
+            zc.postSlice(i);
+            zc.collectSlice(i, diagram.privateEntity());
+        }
+        zc.postRoot();
+        zc.collectRoot(root_);
+        mh.end(size());
+    }
+
+    /**
+     * DD construction distributed over the endpoints of a local transport,
+     * which are driven in turn by this thread.
+     * It runs the same messages as the multi-process construction.
+     * @param spec DD spec.
+     * @param transport the local transport.
+     */
+    template<typename SPEC>
+    DdStructure(DdSpecBase<SPEC,ARITY> const& spec,
+            LocalTransport& transport) :
+            root_(0), useMP(false), reducedSubset(false), progress_(0) {
+        MessageHandler mh;
+        mh.begin(typenameof(spec.entity()));
+        mh << " " << transport.size() << "p";
+        Telemetry tm("build", Telemetry::nameOf(spec.entity()));
+        int const p = transport.size();
+        DdBuilderDistGroup<SPEC> zc(spec.entity(), transport);
+        int n = 0;
+        for (int k = 0; k < p; ++k) {
+            n = zc[k].initialize();
+        }
+
+        mh.setSteps(n);
+        for (int i = n; i > 0; --i) {
+            LevelStats stats;
+            for (int k = 0; k < p; ++k) {
+                zc[k].construct(i);
+                LevelStats const& s = zc[k].levelStats();
+                stats.states += s.states;
+                stats.unique += s.unique;
+                stats.nodes += s.nodes;
+                stats.slots += s.slots;
+                stats.probes += s.probes;
+            }
+            for (int k = 0; k < p; ++k) {
+                zc[k].collect();
+            }
+            tm.record(i, stats);
+            mh.step();
+        }
+
+        diagram = NodeTableHandler<ARITY>(n + 1);
+        NodeTableEntity<ARITY>& table = diagram.privateEntity();
+        for (int i = 1; i <= n; ++i) {
+            for (int k = 0; k < p; ++k) {
+                zc[k].postSlice(i);
+            }
+            for (int k = 0; k < p; ++k) {
+                zc[k].collectSlice(i, table);
+            }
+        }
+        for (int k = 0; k < p; ++k) {
+            zc[k].postRoot();
+        }
+        for (int k = p - 1; k >= 0; --k) {
+            NodeId r;
+            zc[k].collectRoot(k ? r : root_);
+        }
+        mh.end(size());
+    }
+
 private:
+    /**
+     * Writes the reduced ZDD rows of a group of variables.
+     * A node is identified by the number of variables chosen above it
+     * in the group.
+     * The distinct nodes of each level are numbered densely as classes
+     * so that those with the same children are merged by bucketing
+     * in linear time.
+     * @param base the level just below the group.
+     * @param n the number of variables in the group.
+     * @param sizes the set of allowed sizes in the group.
+     * @param f the root of the diagram below the group.
+     * @return the root of the diagram from the top of the group.
+     */
+    NodeId constructSizes_(int base, int n, IntSubset const& sizes,
+            NodeId f) {
+        if (f == 0) return f;
+        NodeTableEntity<ARITY>& table = diagram.privateEntity();
+        std::vector<int> cls(n + 1); // class of each count; 0 for 0-terminal
+        std::vector<NodeId> rep(2);  // node of each class
+        std::vector<int> node(n + 1);
+        std::vector<int> first(n + 1);
+        std::vector<int> head;
+        std::vector<int> link(n + 1);
+        std::vector<int> stamp;
+        std::vector<int> seen;
+        std::vector<int> remap;
+        std::vector<NodeId> nextRep;
+
+        rep[0] = 0;
+        rep[1] = f;
+        for (int c = 0; c <= n; ++c) {
+            cls[c] = sizes.contains(c) ? 1 : 0;
+        }
+
+        for (int k = 1; k <= n; ++k) {
+            int const i = base + k;
+            int const r = rep.size();
+            head.assign(r, -1);
+            for (int c = n - k; c >= 0; --c) {
+                if (cls[c + 1] == 0) continue; // zero-suppressed
+                link[c] = head[cls[c]];
+                head[cls[c]] = c;
+            }
+
+            stamp.assign(r, -1);
+            seen.resize(r);
+            int m = 0;
+            for (int c = 0; c <= n - k; ++c) {
+                node[c] = -1;
+            }
+            for (int a = 0; a < r; ++a) {
+                for (int c = head[a]; c >= 0; c = link[c]) {
+                    int const b = cls[c + 1];
+                    if (stamp[b] != a) {
+                        stamp[b] = a;
+                        seen[b] = m;
+                        first[m++] = c;
+                    }
+                    node[c] = seen[b];
+                }
+            }
+
+            table.initRow(i, m);
+            nextRep.resize(m + 1);
+            nextRep[0] = 0;
+            for (int j = 0; j < m; ++j) {
+                int const c = first[j];
+                NodeId const f0 = rep[cls[c]];
+                Node<ARITY>& p = table[i][j];
+                p.branch[0] = f0;
+                for (int b = 1; b < ARITY; ++b) {
+                    p.branch[b] = rep[cls[c + 1]];
+                }
+                nextRep[j + 1] = NodeId(i, j, f0.hasEmpty());
+            }
+
+            remap.assign(r, -1);
+            remap[0] = 0;
+            for (int c = 0; c <= n - k; ++c) {
+                if (node[c] >= 0) {
+                    cls[c] = node[c] + 1;
+                }
+                else {
+                    int& x = remap[cls[c]];
+                    if (x < 0) {
+                        x = nextRep.size();
+                        nextRep.push_back(rep[cls[c]]);
+                    }
+                    cls[c] = x;
+                }
+            }
+            rep.swap(nextRep);
+        }
+
+        return rep[cls[0]];
+    }
+
     template<typename SPEC>
     void construct_(SPEC const& spec) {
         MessageHandler mh;
         mh.begin(typenameof(spec));
+        Telemetry tm("build", Telemetry::nameOf(spec));
         DdBuilder<SPEC> zc(spec, diagram);
         int n = zc.initialize(root_);
+        Progress pg("build", n);
 
         if (n > 0) {
             mh.setSteps(n);
             for (int i = n; i > 0; --i) {
                 zc.construct(i);
+                tm.record(i, zc.levelStats());
+                if (!pg.report(i, zc.levelStats())) {
+                    zc.destructPending(i);
+                    cancel_("build");
+                }
                 mh.step();
             }
         }
@@ -137,8 +444,10 @@ private:
     void constructMP_(SPEC const& spec) {
         MessageHandler mh;
         mh.begin(typenameof(spec));
+        Telemetry tm("build", Telemetry::nameOf(spec));
         DdBuilderMP<SPEC> zc(spec, diagram);
         int n = zc.initialize(root_);
+        Progress pg("build", n);
 
         if (n > 0) {
 #ifdef _OPENMP
@@ -147,6 +456,11 @@ private:
             mh.setSteps(n);
             for (int i = n; i > 0; --i) {
                 zc.construct(i);
+                tm.record(i, zc.levelStats());
+                if (!pg.report(i, zc.levelStats())) {
+                    zc.destructPending(i);
+                    cancel_("build");
+                }
                 mh.step();
             }
         }
@@ -157,33 +471,120 @@ private:
         mh.end(size());
     }
 
+    /**
+     * Abandons an operation requested to be cancelled.
+     * The diagram is left empty unless a Snapshot_ puts it back.
+     * @param op the operation.
+     */
+    void cancel_(char const* op) {
+        diagram = NodeTableHandler<ARITY>();
+        root_ = 0;
+        throw Cancelled(op);
+    }
+
+    /**
+     * Keeps the diagram before an operation that the progress callback
+     * can cancel, and puts it back unless the operation is committed.
+     * Nothing is kept when no callback is effective.
+     */
+    class Snapshot_ {
+        DdStructure& dd;
+        NodeTableHandler<ARITY> diagram;
+        NodeId root;
+        bool active;
+
+    public:
+        Snapshot_(DdStructure& dd) :
+                dd(dd), root(dd.root_),
+                active(Progress::willReport(dd.progress_)) {
+            if (active) diagram = dd.diagram;
+        }
+
+        ~Snapshot_() {
+            if (!active) return;
+            dd.diagram = diagram;
+            dd.root_ = root;
+        }
+
+        void commit() {
+            active = false;
+        }
+    };
+
 public:
     /**
      * ZDD subsetting.
+     * The result is reduced in place when useReducedSubset() is set.
+     * While a progress callback is effective, the input rows are kept
+     * until the end so that a cancelled subsetting leaves this DD as is.
      * @param spec ZDD spec.
      */
     template<typename SPEC>
     void zddSubset(DdSpecBase<SPEC,ARITY> const& spec) {
+        Snapshot_ snapshot(*this);
 #ifdef _OPENMP
         if (useMP) zddSubsetMP_(spec.entity());
         else
 #endif
         zddSubset_(spec.entity());
+        if (reducedSubset) reduce_<false,true>(true);
+        snapshot.commit();
     }
 
+    /**
+     * ZDD subsetting by two specs in one pass.
+     * The states of the specs are stored side by side and a path is cut
+     * as soon as either of them rejects it, so that no intermediate
+     * diagram is made.
+     * Note that subsetting one by one with zddReduce() in between can be
+     * faster when the reductions merge many states of the first spec.
+     * @param spec1 the first ZDD spec, preferably the more selective one.
+     * @param spec2 the second ZDD spec.
+     */
+    template<typename S1, typename S2>
+    void zddSubset(DdSpecBase<S1,2> const& spec1,
+            DdSpecBase<S2,2> const& spec2) {
+        zddSubset(ZddIntersection<S1,S2>(spec1.entity(), spec2.entity()));
+    }
+
+#if __cplusplus >= 201103L
+    /**
+     * ZDD subsetting by three or more specs in one pass.
+     * (since C++11)
+     * @param spec1 the first ZDD spec, preferably the most selective one.
+     * @param spec2 the second ZDD spec.
+     * @param spec3 the third ZDD spec.
+     * @param specs the other ZDD specs.
+     */
+    template<typename S1, typename S2, typename S3, typename ... SS>
+    void zddSubset(DdSpecBase<S1,2> const& spec1,
+            DdSpecBase<S2,2> const& spec2, DdSpecBase<S3,2> const& spec3,
+            SS const&... specs) {
+        zddSubset(ZddIntersection<S1,S2,S3,SS...>(spec1.entity(),
+                spec2.entity(), spec3.entity(), specs...));
+    }
+#endif
+
 private:
     template<typename SPEC>
     void zddSubset_(SPEC const& spec) {
         MessageHandler mh;
         mh.begin(typenameof(spec));
+        Telemetry tm("subset", Telemetry::nameOf(spec));
         NodeTableHandler<ARITY> tmpTable;
         ZddSubsetter<SPEC> zs(diagram, spec, tmpTable);
         int n = zs.initialize(root_);
+        Progress pg("subset", n, diagram->size(), progress_);
 
         if (n > 0) {
             mh.setSteps(n);
             for (int i = n; i > 0; --i) {
                 zs.subset(i);
+                tm.record(i, zs.levelStats());
+                if (!pg.report(i, zs.levelStats(), (*diagram)[i].size())) {
+                    zs.destructPending(i);
+                    cancel_("subset");
+                }
                 diagram.derefLevel(i);
                 mh.step();
             }
@@ -200,9 +601,11 @@ private:
     void zddSubsetMP_(SPEC const& spec) {
         MessageHandler mh;
         mh.begin(typenameof(spec));
+        Telemetry tm("subset", Telemetry::nameOf(spec));
         NodeTableHandler<ARITY> tmpTable;
         ZddSubsetterMP<SPEC> zs(diagram, spec, tmpTable);
         int n = zs.initialize(root_);
+        Progress pg("subset", n, diagram->size(), progress_);
 
         if (n > 0) {
 #ifdef _OPENMP
@@ -211,6 +614,11 @@ private:
             mh.setSteps(n);
             for (int i = n; i > 0; --i) {
                 zs.subset(i);
+                tm.record(i, zs.levelStats());
+                if (!pg.report(i, zs.levelStats(), (*diagram)[i].size())) {
+                    zs.destructPending(i);
+                    cancel_("subset");
+                }
                 diagram.derefLevel(i);
                 mh.step();
             }
@@ -235,6 +643,34 @@ public:
         return old;
     }
 
+    /**
+     * Makes zddSubset() produce a ZDD-reduced diagram.
+     * The subsetter works top-down and equivalent nodes are found only
+     * after the bottom level is done, so the reduction is applied to
+     * the node table of the subsetting result in place, keeping the
+     * peak memory to that of the subsetting.
+     * @param flag true for reducing the subsetting results.
+     * @return old value of the flag.
+     */
+    bool useReducedSubset(bool flag = true) {
+        bool old = reducedSubset;
+        reducedSubset = flag;
+        return old;
+    }
+
+    /**
+     * Sets the progress callback of the operations on this DD.
+     * The operations without it report to the default callback of
+     * the calling thread set by Progress::setCallback().
+     * @param cb the callback or null.
+     * @return old callback.
+     */
+    ProgressCallback* setProgressCallback(ProgressCallback* cb) {
+        ProgressCallback* old = progress_;
+        progress_ = cb;
+        return old;
+    }
+
     /**
      * Gets the root node.
      * @return root node ID.
@@ -360,34 +796,51 @@ public:
     /**
      * QDD reduction.
      * No node deletion rule is applied.
+     * @param inPlace overwrite the node table instead of making a new one.
      */
-    void qddReduce() {
-        reduce<false,false>();
+    void qddReduce(bool inPlace = false) {
+        reduce<false,false>(inPlace);
     }
 
     /**
      * BDD reduction.
      * The node of which two edges points to the identical node is deleted.
+     * @param inPlace overwrite the node table instead of making a new one.
      */
-    void bddReduce() {
-        reduce<true,false>();
+    void bddReduce(bool inPlace = false) {
+        reduce<true,false>(inPlace);
     }
 
     /**
      * ZDD reduction.
      * The node of which 1-edge points to the 0-terminal is deleted.
+     * @param inPlace overwrite the node table instead of making a new one.
      */
-    void zddReduce() {
-        reduce<false,true>();
+    void zddReduce(bool inPlace = false) {
+        reduce<false,true>(inPlace);
     }
 
     /**
      * BDD/ZDD reduction.
+     * The in-place mode keeps the peak memory close to the input size
+     * at the cost of hashing every node even for binary DDs.
+     * While a progress callback is effective, the reduction works on
+     * a copy of the node table so that a cancelled reduction leaves
+     * this DD as is.
      * @tparam BDD enable BDD reduction.
      * @tparam ZDD enable ZDD reduction.
+     * @param inPlace overwrite the node table instead of making a new one.
      */
     template<bool BDD, bool ZDD>
-    void reduce() {
+    void reduce(bool inPlace = false) {
+        Snapshot_ snapshot(*this);
+        reduce_<BDD,ZDD>(inPlace);
+        snapshot.commit();
+    }
+
+private:
+    template<bool BDD, bool ZDD>
+    void reduce_(bool inPlace) {
         MessageHandler mh;
         mh.begin("reduction");
         int n = root_.row();
@@ -396,12 +849,17 @@ public:
         if (useMP) mh << " " << omp_get_max_threads() << "x";
 #endif
 
-        DdReducer<ARITY,BDD,ZDD> zr(diagram, useMP);
+        Telemetry tm("reduce", BDD ? "BDD" : ZDD ? "ZDD" : "QDD");
+        Progress pg("reduce", n, diagram->size(), progress_);
+        DdReducer<ARITY,BDD,ZDD> zr(diagram, useMP, inPlace);
         zr.setRoot(root_);
 
         mh.setSteps(n);
         for (int i = 1; i <= n; ++i) {
             zr.reduce(i, useMP);
+            tm.record(i, zr.levelStats());
+            LevelStats const& stats = zr.levelStats();
+            if (!pg.report(i, stats, stats.states)) cancel_("reduce");
             mh.step();
         }
 
@@ -409,14 +867,29 @@ public:
     }
 
 public:
+    /**
+     * Renumbers the nodes in each level in parent order.
+     * It improves the memory locality of the subsequent traversals
+     * such as evaluate() after reduction.
+     */
+    void optimizeLayout() {
+        MessageHandler mh;
+        mh.begin("layout");
+        diagram.privateEntity().optimizeLayout(root_);
+        mh.end(size());
+    }
+
     /**
      * Transforms a BDD into a ZDD.
      * @param numVars the number of variables.
      */
     DdStructure bdd2zdd(int numVars) const {
-        return DdStructure(
-                ZddLookahead<BddUnreduction<DdStructure> >(
-                        BddUnreduction<DdStructure>(*this, numVars)), useMP);
+        DdStructure dd;
+        dd.useMP = useMP;
+        dd.reducedSubset = reducedSubset;
+        dd.progress_ = progress_;
+        dd.convertFrom<false,true>(*this, numVars);
+        return dd;
     }
 
     /**
@@ -424,11 +897,51 @@ public:
      * @param numVars the number of variables.
      */
     DdStructure zdd2bdd(int numVars) const {
-        return DdStructure(
-                BddLookahead<ZddUnreduction<DdStructure> >(
-                        ZddUnreduction<DdStructure>(*this, numVars)), useMP);
+        DdStructure dd;
+        dd.useMP = useMP;
+        dd.reducedSubset = reducedSubset;
+        dd.progress_ = progress_;
+        dd.convertFrom<true,false>(*this, numVars);
+        return dd;
+    }
+
+private:
+    /**
+     * Makes this DD by bottom-up BDD/ZDD conversion of another DD.
+     * @tparam BDD convert into a BDD.
+     * @tparam ZDD convert into a ZDD.
+     * @param o the source DD.
+     * @param numVars the number of variables.
+     */
+    template<bool BDD, bool ZDD>
+    void convertFrom(DdStructure const& o, int numVars) {
+        MessageHandler mh;
+        mh.begin(BDD ? "zdd2bdd" : "bdd2zdd");
+
+#ifdef _OPENMP
+        if (useMP) mh << " " << omp_get_max_threads() << "x";
+#endif
+
+        root_ = o.root_;
+        DdConverter<ARITY,BDD,ZDD> dc(o.diagram, diagram, numVars);
+        int n = dc.initialize(root_);
+
+        if (n > 0) {
+            mh.setSteps(n);
+            for (int i = 1; i <= n; ++i) {
+                dc.convert(i, useMP);
+                mh.step();
+            }
+        }
+        else {
+            mh << " ...";
+        }
+
+        mh.end(size());
     }
 
+public:
+
     /**
      * Counts the number of minterms of the function represented by this BDD.
      * @param numVars the number of input variables of the function.
@@ -483,6 +996,9 @@ public:
         }
 #endif
 
+        Telemetry tm("evaluate", Telemetry::nameOf(eval));
+        Progress pg("evaluate", n, diagram->size(), progress_);
+        LevelStats stats;
         DataTable<T> work(diagram->numRows());
         {
             size_t const m = (*diagram)[0].size();
@@ -542,6 +1058,9 @@ public:
                 }
             }
 #endif
+            stats.states = stats.unique = stats.nodes = m;
+            tm.record(i, stats);
+            if (!pg.report(i, stats, m)) throw Cancelled("evaluate");
             if (msg) mh.step();
         }
 
@@ -696,56 +1215,162 @@ public:
         return f.hash();
     }
 
+    /**
+     * Reads a ZDD in Sapporo format such as the output of dumpSapporo.
+     * Works only for binary DDs.
+     * The input is scanned in parallel if MP algorithms are enabled.
+     * @param filename the file name or an empty string for STDIN.
+     */
+    void readSapporo(std::string const& filename = "") {
+        import_(filename, ZddImporter<ARITY>::SAPPORO);
+    }
+
+    /**
+     * Reads a ZDD in Graphillion's dump format.
+     * Works only for binary DDs.
+     * The input is scanned in parallel if MP algorithms are enabled.
+     * @param filename the file name or an empty string for STDIN.
+     */
+    void readGraphillion(std::string const& filename = "") {
+        import_(filename, ZddImporter<ARITY>::GRAPHILLION);
+    }
+
+private:
+    void import_(std::string const& filename,
+            typename ZddImporter<ARITY>::Format format) {
+        MessageHandler mh;
+        mh.begin("reading");
+        mh << (filename.empty() ? " STDIN" : " \"" + filename + "\"");
+#ifdef _OPENMP
+        if (useMP) mh << " " << omp_get_max_threads() << "x";
+#endif
+        mh << " ...";
+
+        MappedFile mf(filename);
+        ZddImporter<ARITY> zi(format, useMP);
+        root_ = zi.read(diagram, mf.begin(), mf.end());
+
+        mh.end(size());
+    }
+
+public:
     /**
      * Dumps the node table in Sapporo ZDD format.
      * Works only for binary DDs.
      * @param os the output stream.
      */
     void dumpSapporo(std::ostream& os) const {
+        OutputBuffer out(os);
+        dumpSapporo(out);
+        out.flush();
+    }
+
+    /**
+     * Dumps the node table in Sapporo ZDD format.
+     * Works only for binary DDs.
+     * Levels are formatted in parallel if MP algorithms are enabled.
+     * @param out the output buffer.
+     */
+    void dumpSapporo(OutputBuffer& out) const {
         int const n = diagram->numRows() - 1;
-        size_t const l = size();
 
-        os << "_i " << n << "\n";
-        os << "_o 1\n";
-        os << "_n " << l << "\n";
+        /* The nodes are numbered 2, 4, 6, ... from the bottom level,
+         * so that the ID of (i,j) is 2 * (base[i] + j + 1). */
+        MyVector<size_t> base(n + 2);
+        base[1] = 0;
+        for (int i = 1; i <= n; ++i) {
+            base[i + 1] = base[i] + (*diagram)[i].size();
+        }
+        assert(base[n + 1] == size());
 
-        DataTable<size_t> nodeId(diagram->numRows());
-        size_t k = 0;
+        out << "_i " << n << "\n";
+        out << "_o 1\n";
+        out << "_n " << base[n + 1] << "\n";
 
-        for (int i = 1; i <= n; ++i) {
-            size_t const m = (*diagram)[i].size();
-            Node<ARITY> const* p = (*diagram)[i].data();
-            nodeId[i].resize(m);
-
-            for (size_t j = 0; j < m; ++j, ++p) {
-                k += 2;
-                nodeId[i][j] = k;
-                os << k << " " << i;
-
-                for (int c = 0; c <= 1; ++c) {
-                    NodeId fc = p->branch[c];
-                    if (fc == 0) {
-                        os << " F";
-                    }
-                    else if (fc == 1) {
-                        os << " T";
-                    }
-                    else {
-                        os << " " << nodeId[fc.row()][fc.col()];
-                    }
+#ifdef _OPENMP
+        if (useMP) {
+            MyVector<SapporoChunk> chunks;
+            for (int i = 1; i <= n; ++i) {
+                size_t const m = (*diagram)[i].size();
+                for (size_t j = 0; j < m; j += SAPPORO_CHUNK_SIZE) {
+                    chunks.push_back(
+                            SapporoChunk(i, j,
+                                    std::min(j + SAPPORO_CHUNK_SIZE, m)));
                 }
-
-                os << "\n";
             }
 
-            MyVector<int> const& levels = diagram->lowerLevels(i);
-            for (int const* t = levels.begin(); t != levels.end(); ++t) {
-                nodeId[*t].clear();
+            intmax_t const batch = omp_get_max_threads() * 4;
+            std::vector<std::string> text(batch);
+
+            for (size_t c0 = 0; c0 < chunks.size(); c0 += batch) {
+                intmax_t const k1 = std::min(chunks.size() - c0,
+                        size_t(batch));
+
+#pragma omp parallel for schedule(dynamic)
+                for (intmax_t k = 0; k < k1; ++k) {
+                    SapporoChunk const& c = chunks[c0 + k];
+                    text[k].clear();
+                    OutputBuffer buf(text[k], 1 << 16);
+                    dumpSapporoNodes(buf, base, c.row, c.begin, c.end);
+                }
+
+                for (intmax_t k = 0; k < k1; ++k) {
+                    out.write(text[k].data(), text[k].size());
+                }
             }
         }
+        else
+#endif
+        for (int i = 1; i <= n; ++i) {
+            dumpSapporoNodes(out, base, i, 0, (*diagram)[i].size());
+        }
+
+        dumpSapporoId(out, base, root_);
+        out << '\n';
+    }
+
+private:
+    static size_t const SAPPORO_CHUNK_SIZE = 1 << 16;
+
+    struct SapporoChunk {
+        int row;
+        size_t begin;
+        size_t end;
 
-        os << nodeId[root_.row()][root_.col()] << "\n";
-        assert(k == l * 2);
+        SapporoChunk() :
+                row(0), begin(0), end(0) {
+        }
+
+        SapporoChunk(int row, size_t begin, size_t end) :
+                row(row), begin(begin), end(end) {
+        }
+    };
+
+    static void dumpSapporoId(OutputBuffer& out, MyVector<size_t> const& base,
+            NodeId f) {
+        if (f == 0) {
+            out << 'F';
+        }
+        else if (f == 1) {
+            out << 'T';
+        }
+        else {
+            out.putUnsigned(2 * (base[f.row()] + f.col() + 1));
+        }
+    }
+
+    void dumpSapporoNodes(OutputBuffer& out, MyVector<size_t> const& base,
+            int i, size_t begin, size_t end) const {
+        Node<ARITY> const* p = (*diagram)[i].data() + begin;
+
+        for (size_t j = begin; j < end; ++j, ++p) {
+            out.putUnsigned(2 * (base[i] + j + 1)) << ' ' << i;
+            for (int c = 0; c <= 1; ++c) {
+                out << ' ';
+                dumpSapporoId(out, base, p->branch[c]);
+            }
+            out << '\n';
+        }
     }
 };
 
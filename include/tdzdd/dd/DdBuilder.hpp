@@ -24,10 +24,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <new>
 #include <ostream>
 #include <stdexcept>
+#include <vector>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -37,11 +40,14 @@
 #include "Node.hpp"
 #include "NodeTable.hpp"
 #include "../DdSpec.hpp"
+#include "../util/CPUAffinity.hpp"
 #include "../util/MemoryPool.hpp"
 #include "../util/MessageHandler.hpp"
 #include "../util/MyHashTable.hpp"
 #include "../util/MyList.hpp"
 #include "../util/MyVector.hpp"
+#include "../util/PerfCounter.hpp"
+#include "../util/Telemetry.hpp"
 
 namespace tdzdd {
 
@@ -149,6 +155,28 @@ protected:
         return headerSize + (n + sizeof(SpecNode) - 1) / sizeof(SpecNode);
     }
 
+    /**
+     * Remakes the copy of the spec for a bound thread
+     * so that the copy is allocated on the node of the thread.
+     * Nothing is done unless CPUAffinity is enabled.
+     * Copies are made one at a time because a spec may share
+     * reference-counted data, such as a DdStructure, with the others.
+     * @param specs the copies of the spec for the threads.
+     * @param y the thread number.
+     */
+    template<typename SPEC>
+    static void localize(MyVector<SPEC>& specs, int y) {
+        if (!CPUAffinity::enabled()) return;
+        if (y == 0) return;
+#ifdef _OPENMP
+#pragma omp critical(tdzdd_localize)
+#endif
+        {
+            specs[y].~SPEC();
+            new (&specs[y]) SPEC(specs[0]);
+        }
+    }
+
     template<typename SPEC>
     struct Hasher {
         SPEC const& spec;
@@ -187,6 +215,7 @@ class DdBuilder: DdBuilderBase {
     MyVector<char> oneStorage;
     void* const one;
     MyVector<NodeBranchId> oneSrcPtr;
+    LevelStats stats;
 
     void init(int n) {
         snodeTable.resize(n + 1);
@@ -263,6 +292,9 @@ public:
         size_t m = j0;
         int lowestChild = i - 1;
         size_t deadCount = 0;
+        stats.clear();
+        stats.states = snodes.size();
+        PerfScope dedup("build.dedup", i);
 
         {
             Hasher<Spec> hasher(spec, i);
@@ -298,8 +330,14 @@ public:
 //            MessageHandler mh;
 //            mh << "table_size[" << i << "] = " << uniq.tableSize() << "\n";
 //#endif
+            stats.slots = uniq.tableSize();
+            stats.probes = uniq.collisions();
         }
 
+        dedup.stop();
+        PerfScope expand("build.expand", i);
+        stats.unique = m - j0;
+        stats.nodes = m;
         output[i].resize(m);
         Node<AR>* const outi = output[i].data();
         size_t jj = j0;
@@ -384,7 +422,30 @@ public:
 
         snodeTable[i - 1].pop_front();
         spec.destructLevel(i);
-        sweeper.update(i, lowestChild, deadCount);
+        stats.dead = deadCount;
+        stats.swept = sweeper.update(i, lowestChild, deadCount);
+    }
+
+    /**
+     * Destructs the states scheduled below a level
+     * in order to abandon the construction.
+     * @param i the last level built.
+     */
+    void destructPending(int i) {
+        for (int k = std::min(i, int(snodeTable.size())) - 1; k >= 0; --k) {
+            MyList<SpecNode>& snodes = snodeTable[k];
+            for (; !snodes.empty(); snodes.pop_front()) {
+                spec.destruct(state(snodes.front()));
+            }
+        }
+    }
+
+    /**
+     * Gets the counters of the last level built.
+     * @return the counters.
+     */
+    LevelStats const& levelStats() const {
+        return stats;
     }
 };
 
@@ -407,13 +468,21 @@ class DdBuilderMP: DdBuilderMPBase {//TODO oneStorage
     DdSweeper<AR> sweeper;
 
     MyVector<MyVector<MyVector<MyList<SpecNode> > > > snodeTables;
+    LevelStats stats;
 
 #ifdef DEBUG
     ElapsedTimeCounter etcP1, etcP2, etcS1;
 #endif
 
     void init(int n) {
+        // the thread y touches its own tables first when bound
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) if (CPUAffinity::enabled())
+#endif
         for (int y = 0; y < threads; ++y) {
+            CPUAffinity affinity;
+            affinity.bind(y);
+            localize(specs, y);
             snodeTables[y].resize(tasks);
             for (int x = 0; x < tasks; ++x) {
                 snodeTables[y][x].resize(n + 1);
@@ -498,6 +567,10 @@ public:
         MyVector<size_t> nodeColumn(tasks);
         int lowestChild = i - 1;
         size_t deadCount = 0;
+        size_t states = 0;
+        size_t slots = 0;
+        size_t probes = 0;
+        size_t const m0 = output[i].size();
 
 #ifdef DEBUG
         etcP1.start();
@@ -505,12 +578,13 @@ public:
 
 #ifdef _OPENMP
         // OpenMP 2.0 does not support reduction(min:lowestChild)
-#pragma omp parallel reduction(+:deadCount)
+#pragma omp parallel reduction(+:deadCount,states,slots,probes)
 #endif
         {
 #ifdef _OPENMP
             int yy = omp_get_thread_num();
-            //CPUAffinity().bind(yy);
+            CPUAffinity affinity;
+            affinity.bind(yy);
 #else
             int yy = 0;
 #endif
@@ -521,6 +595,7 @@ public:
             Hasher<Spec> hasher(spec, i);
             UniqTable uniq(hasher, hasher);
             int lc = lowestChild;
+            PerfScope p1("build.P1", i);
 
 #ifdef _OPENMP
 #pragma omp for schedule(dynamic)
@@ -565,6 +640,9 @@ public:
                 }
 
                 nodeColumn[x] = j;
+                states += m;
+                slots += uniq.tableSize();
+                probes += uniq.collisions();
 //#ifdef DEBUG
 //                MessageHandler mh;
 //#ifdef _OPENMP
@@ -574,6 +652,8 @@ public:
 //#endif
             }
 
+            p1.stop();
+
 #ifdef _OPENMP
 #pragma omp single
 #endif
@@ -582,6 +662,7 @@ public:
                 etcP1.stop();
                 etcS1.start();
 #endif
+                PerfScope s1("build.S1", i);
                 size_t m = output[i].size();
                 for (int x = 0; x < tasks; ++x) {
                     size_t j = nodeColumn[x];
@@ -596,6 +677,8 @@ public:
 #endif
             }
 
+            PerfScope p2("build.P2", i);
+
 #ifdef _OPENMP
 #pragma omp for schedule(dynamic)
 #endif
@@ -657,6 +740,7 @@ public:
             }
 
             spec.destructLevel(i);
+            p2.stop();
 
 #ifdef _OPENMP
 #pragma omp critical
@@ -664,11 +748,438 @@ public:
             if (lc < lowestChild) lowestChild = lc;
         }
 
-        sweeper.update(i, lowestChild, deadCount);
+        stats.states = states;
+        stats.unique = output[i].size() - m0;
+        stats.nodes = output[i].size();
+        stats.dead = deadCount;
+        stats.slots = slots;
+        stats.probes = probes;
+        stats.swept = sweeper.update(i, lowestChild, deadCount);
 #ifdef DEBUG
         etcP2.stop();
 #endif
     }
+
+    /**
+     * Destructs the states scheduled below a level
+     * in order to abandon the construction.
+     * @param i the last level built.
+     */
+    void destructPending(int i) {
+        for (int y = 0; y < threads; ++y) {
+            for (int x = 0; x < int(snodeTables[y].size()); ++x) {
+                MyVector<MyList<SpecNode> >& table = snodeTables[y][x];
+                for (int k = std::min(i, int(table.size())) - 1; k >= 0; --k) {
+                    MyList<SpecNode>& snodes = table[k];
+                    for (; !snodes.empty(); snodes.pop_front()) {
+                        specs[y].destruct(state(snodes.front()));
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Gets the counters of the last level built.
+     * @return the counters.
+     */
+    LevelStats const& levelStats() const {
+        return stats;
+    }
+};
+
+/**
+ * Breadth-first DD builder bounding the number of nodes in each level.
+ * When a level is too wide, its nodes are ranked by the weight of their
+ * heaviest path from the root plus score_state, and the nodes below
+ * the bound are either forwarded to the 0-terminal, which makes
+ * a restricted DD representing a subfamily, or merged into one node
+ * by relax_states, which makes a relaxed DD representing a superfamily.
+ * The weight of a path is the sum of the weights of the levels
+ * where it takes a nonzero branch.
+ */
+template<typename S>
+class DdBuilderBounded {
+    typedef S Spec;
+    static int const AR = Spec::ARITY;
+    static int const headerSize = 3;
+
+    /* SpecNode
+     * ┌────────┬────────┬────────┬────────┬────────┬─────
+     * │ srcPtr │  code  │ weight │state[0]│state[1]│ ...
+     * └────────┴────────┴────────┴────────┴────────┴─────
+     * code:   the index of the unique state, or -1 for the 0-terminal.
+     * weight: the weight of the heaviest path from the root.
+     */
+    union SpecNode {
+        NodeId* srcPtr;
+        int64_t code;
+        double weight;
+    };
+
+    static NodeId*& srcPtr(SpecNode* p) {
+        return p[0].srcPtr;
+    }
+
+    static int64_t& code(SpecNode* p) {
+        return p[1].code;
+    }
+
+    static double& weight(SpecNode* p) {
+        return p[2].weight;
+    }
+
+    static void* state(SpecNode* p) {
+        return p + headerSize;
+    }
+
+    static void const* state(SpecNode const* p) {
+        return p + headerSize;
+    }
+
+    static int getSpecNodeSize(int n) {
+        if (n < 0)
+            throw std::runtime_error("storage size is not initialized!!!");
+        return headerSize + (n + sizeof(SpecNode) - 1) / sizeof(SpecNode);
+    }
+
+    struct Hasher {
+        Spec const& spec;
+        int const level;
+
+        Hasher(Spec const& spec, int level) :
+                spec(spec), level(level) {
+        }
+
+        size_t operator()(SpecNode const* p) const {
+            return spec.hash_code(state(p), level);
+        }
+
+        size_t operator()(SpecNode const* p, SpecNode const* q) const {
+            return spec.equal_to(state(p), state(q), level);
+        }
+    };
+
+    struct HigherRank {
+        MyVector<double> const& rank;
+
+        HigherRank(MyVector<double> const& rank) :
+                rank(rank) {
+        }
+
+        bool operator()(size_t a, size_t b) const {
+            return rank[a] > rank[b] || (rank[a] == rank[b] && a < b);
+        }
+    };
+
+    typedef MyHashTable<SpecNode*,Hasher,Hasher> UniqTable;
+
+    Spec spec;
+    int const specNodeSize;
+    size_t const maxWidth;
+    bool const relaxed;
+    std::vector<double> const weights;
+    NodeTableEntity<AR>& output;
+    DdSweeper<AR> sweeper;
+
+    MyVector<MyList<SpecNode> > snodeTable;
+
+    MyVector<char> oneStorage;
+    void* const one;
+    MyVector<NodeBranchId> oneSrcPtr;
+
+    MyVector<SpecNode*> uniqNodes; ///< null when forwarded to the 0-terminal.
+    MyVector<size_t> mergedInto;
+    MyVector<double> rank;
+    MyVector<size_t> order;
+    MyVector<NodeId> ids;
+    LevelStats stats;
+
+    double weightOf(int i) const {
+        return size_t(i) < weights.size() ? weights[i] : 0;
+    }
+
+    void init(int n) {
+        snodeTable.resize(n + 1);
+        if (n >= output.numRows()) output.setNumRows(n + 1);
+        oneSrcPtr.clear();
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param spec DD spec.
+     * @param output the result.
+     * @param maxWidth the maximum number of nodes in a level.
+     * @param relaxed merge the nodes instead of dropping them.
+     * @param weights the weight of each level.
+     */
+    DdBuilderBounded(Spec const& spec, NodeTableHandler<AR>& output,
+            size_t maxWidth, bool relaxed,
+            std::vector<double> const& weights = std::vector<double>()) :
+            spec(spec),
+            specNodeSize(getSpecNodeSize(spec.datasize())),
+            maxWidth(maxWidth),
+            relaxed(relaxed),
+            weights(weights),
+            output(output.privateEntity()),
+            sweeper(this->output, oneSrcPtr),
+            oneStorage(spec.datasize()),
+            one(oneStorage.data()) {
+        if (maxWidth < 1) throw std::runtime_error("maxWidth must be positive");
+    }
+
+    ~DdBuilderBounded() {
+        if (!oneSrcPtr.empty()) {
+            spec.destruct(one);
+            oneSrcPtr.clear();
+        }
+    }
+
+    /**
+     * Initializes the builder.
+     * @param root result storage.
+     */
+    int initialize(NodeId& root) {
+        sweeper.setRoot(root);
+        MyVector<char> tmp(spec.datasize());
+        void* const tmpState = tmp.data();
+        int n = spec.get_root(tmpState);
+
+        if (n <= 0) {
+            root = n ? 1 : 0;
+            n = 0;
+        }
+        else {
+            init(n);
+            SpecNode* p0 = snodeTable[n].alloc_front(specNodeSize);
+            spec.get_copy(state(p0), tmpState);
+            srcPtr(p0) = &root;
+            weight(p0) = 0;
+        }
+
+        spec.destruct(tmpState);
+        if (!oneSrcPtr.empty()) {
+            spec.destruct(one);
+            oneSrcPtr.clear();
+        }
+        return n;
+    }
+
+    /**
+     * Builds one level.
+     * @param i level.
+     */
+    void construct(int i) {
+        assert(0 < i && size_t(i) < snodeTable.size());
+
+        MyList<SpecNode> &snodes = snodeTable[i];
+        int lowestChild = i - 1;
+        size_t deadCount = 0;
+        stats.clear();
+        stats.states = snodes.size();
+        uniqNodes.clear();
+
+        {
+            Hasher hasher(spec, i);
+            UniqTable uniq(snodes.size() * 2, hasher, hasher);
+
+            for (typename MyList<SpecNode>::iterator t = snodes.begin();
+                    t != snodes.end(); ++t) {
+                SpecNode* p = *t;
+                SpecNode*& p0 = uniq.add(p);
+
+                if (p0 == p) {
+                    code(p) = uniqNodes.size();
+                    uniqNodes.push_back(p);
+                }
+                else {
+                    switch (spec.merge_states(state(p0), state(p))) {
+                    case 1:
+                        uniqNodes[code(p0)] = 0; // forward to 0-terminal
+                        code(p) = uniqNodes.size();
+                        uniqNodes.push_back(p);
+                        p0 = p;
+                        break;
+                    case 2:
+                        code(p) = -1;
+                        break;
+                    default:
+                        code(p) = code(p0);
+                        weight(p0) = std::max(weight(p0), weight(p));
+                        break;
+                    }
+                }
+            }
+
+            stats.slots = uniq.tableSize();
+            stats.probes = uniq.collisions();
+        }
+
+        size_t const u = uniqNodes.size();
+        mergedInto.resize(u);
+        rank.resize(u);
+        order.clear();
+        for (size_t k = 0; k < u; ++k) {
+            mergedInto[k] = k;
+            SpecNode* p = uniqNodes[k];
+            if (p == 0) continue;
+            rank[k] = weight(p) + spec.score_state(state(p), i);
+            order.push_back(k);
+        }
+        stats.unique = order.size();
+
+        if (order.size() > maxWidth) {
+            std::sort(order.begin(), order.end(), HigherRank(rank));
+
+            if (relaxed) {
+                size_t r = order[maxWidth - 1];
+                for (size_t t = maxWidth; t < order.size(); ++t) {
+                    size_t k = order[t];
+                    SpecNode* p = uniqNodes[r];
+                    SpecNode* q = uniqNodes[k];
+                    switch (spec.relax_states(state(p), state(q), i)) {
+                    case 1:
+                        uniqNodes[r] = 0; // forward to 0-terminal
+                        r = k;
+                        break;
+                    case 2:
+                        uniqNodes[k] = 0;
+                        break;
+                    default:
+                        mergedInto[k] = r;
+                        weight(p) = std::max(weight(p), weight(q));
+                        break;
+                    }
+                }
+            }
+            else {
+                for (size_t t = maxWidth; t < order.size(); ++t) {
+                    uniqNodes[order[t]] = 0;
+                }
+            }
+        }
+
+        size_t m = output[i].size();
+        ids.resize(u);
+        for (size_t k = 0; k < u; ++k) {
+            bool alive = uniqNodes[k] != 0 && mergedInto[k] == k;
+            ids[k] = alive ? NodeId(i, m++) : NodeId(0);
+        }
+        for (size_t k = 0; k < u; ++k) {
+            if (mergedInto[k] != k) ids[k] = ids[mergedInto[k]];
+        }
+        for (typename MyList<SpecNode>::iterator t = snodes.begin();
+                t != snodes.end(); ++t) {
+            SpecNode* p = *t;
+            *srcPtr(p) = (code(p) < 0) ? NodeId(0) : ids[code(p)];
+        }
+
+        stats.nodes = m;
+        output[i].resize(m);
+        Node<AR>* const outi = output[i].data();
+        SpecNode* pp = snodeTable[i - 1].alloc_front(specNodeSize);
+
+        for (size_t k = 0; k < u; ++k) {
+            SpecNode* p = uniqNodes[k];
+            if (p == 0 || mergedInto[k] != k) continue;
+            size_t jj = ids[k].col();
+            Node<AR>& q = outi[jj];
+            bool allZero = true;
+
+            for (int b = 0; b < AR; ++b) {
+                spec.get_copy(state(pp), state(p));
+                int ii = spec.get_child(state(pp), i, b);
+                double w = weight(p) + (b ? weightOf(i) : 0);
+
+                if (ii == 0) {
+                    q.branch[b] = 0;
+                    spec.destruct(state(pp));
+                }
+                else if (ii < 0) {
+                    if (oneSrcPtr.empty()) { // the first 1-terminal candidate
+                        spec.get_copy(one, state(pp));
+                        q.branch[b] = 1;
+                        oneSrcPtr.push_back(NodeBranchId(i, jj, b));
+                    }
+                    else {
+                        switch (spec.merge_states(one, state(pp))) {
+                        case 1:
+                            while (!oneSrcPtr.empty()) {
+                                NodeBranchId const& nbi = oneSrcPtr.back();
+                                assert(nbi.row >= i);
+                                output[nbi.row][nbi.col].branch[nbi.val] = 0;
+                                oneSrcPtr.pop_back();
+                            }
+                            spec.destruct(one);
+                            spec.get_copy(one, state(pp));
+                            q.branch[b] = 1;
+                            oneSrcPtr.push_back(NodeBranchId(i, jj, b));
+                            break;
+                        case 2:
+                            q.branch[b] = 0;
+                            break;
+                        default:
+                            q.branch[b] = 1;
+                            oneSrcPtr.push_back(NodeBranchId(i, jj, b));
+                            break;
+                        }
+                    }
+                    spec.destruct(state(pp));
+                    allZero = false;
+                }
+                else if (ii == i - 1) {
+                    srcPtr(pp) = &q.branch[b];
+                    weight(pp) = w;
+                    pp = snodeTable[ii].alloc_front(specNodeSize);
+                    allZero = false;
+                }
+                else {
+                    assert(ii < i - 1);
+                    SpecNode* ppp = snodeTable[ii].alloc_front(specNodeSize);
+                    spec.get_copy(state(ppp), state(pp));
+                    spec.destruct(state(pp));
+                    srcPtr(ppp) = &q.branch[b];
+                    weight(ppp) = w;
+                    if (ii < lowestChild) lowestChild = ii;
+                    allZero = false;
+                }
+            }
+
+            if (allZero) ++deadCount;
+        }
+
+        for (; !snodes.empty(); snodes.pop_front()) {
+            spec.destruct(state(snodes.front()));
+        }
+
+        snodeTable[i - 1].pop_front();
+        spec.destructLevel(i);
+        stats.dead = deadCount;
+        stats.swept = sweeper.update(i, lowestChild, deadCount);
+    }
+
+    /**
+     * Destructs the states scheduled below a level
+     * in order to abandon the construction.
+     * @param i the last level built.
+     */
+    void destructPending(int i) {
+        for (int k = std::min(i, int(snodeTable.size())) - 1; k >= 0; --k) {
+            MyList<SpecNode>& snodes = snodeTable[k];
+            for (; !snodes.empty(); snodes.pop_front()) {
+                spec.destruct(state(snodes.front()));
+            }
+        }
+    }
+
+    /**
+     * Gets the counters of the last level built.
+     * @return the counters.
+     */
+    LevelStats const& levelStats() const {
+        return stats;
+    }
 };
 
 /**
@@ -693,6 +1204,7 @@ class ZddSubsetter: DdBuilderBase {
     MyVector<NodeBranchId> oneSrcPtr;
 
     MemoryPools pools;
+    LevelStats stats;
 
 public:
     ZddSubsetter(NodeTableHandler<AR> const& input, Spec const& s,
@@ -782,10 +1294,12 @@ public:
 
         if (work[i].empty()) work[i].resize(m);
         assert(work[i].size() == m);
+        stats.clear();
 
         for (size_t j = 0; j < m; ++j) {
             MyListOnPool<SpecNode> &list = work[i][j];
             size_t n = list.size();
+            stats.states += n;
 
             if (n >= 2) {
                 UniqTable uniq(n * 2, hasher, hasher);
@@ -816,6 +1330,9 @@ public:
                         }
                     }
                 }
+
+                stats.slots += uniq.tableSize();
+                stats.probes += uniq.collisions();
             }
             else if (n == 1) {
                 SpecNode* p = list.front();
@@ -823,6 +1340,7 @@ public:
             }
         }
 
+        stats.unique = stats.nodes = mm;
         output.initRow(i, mm);
         Node<AR>* const outi = output[i].data();
         size_t jj = 0;
@@ -925,7 +1443,35 @@ public:
         work[i].clear();
         pools[i].clear();
         spec.destructLevel(i);
-        sweeper.update(i, lowestChild, deadCount);
+        stats.dead = deadCount;
+        stats.swept = sweeper.update(i, lowestChild, deadCount);
+    }
+
+    /**
+     * Destructs the states scheduled below a level
+     * in order to abandon the construction.
+     * @param i the last level built.
+     */
+    void destructPending(int i) {
+        for (int k = std::min(i, work.numRows()) - 1; k >= 0; --k) {
+            for (size_t j = 0; j < work[k].size(); ++j) {
+                MyListOnPool<SpecNode>& list = work[k][j];
+                for (MyListOnPool<SpecNode>::iterator t = list.begin();
+                        t != list.end(); ++t) {
+                    spec.destruct(state(*t));
+                }
+            }
+            work[k].clear();
+            if (size_t(k) < pools.size()) pools[k].clear();
+        }
+    }
+
+    /**
+     * Gets the counters of the last level built.
+     * @return the counters.
+     */
+    LevelStats const& levelStats() const {
+        return stats;
     }
 
 private:
@@ -971,6 +1517,7 @@ class ZddSubsetterMP: DdBuilderMPBase { //TODO oneStorage
 
     MyVector<MyVector<MyVector<MyListOnPool<SpecNode> > > > snodeTables;
     MyVector<MemoryPools> pools;
+    LevelStats stats;
 
 public:
     ZddSubsetterMP(NodeTableHandler<AR> const& input,
@@ -1024,7 +1571,13 @@ public:
             assert(n == k);
             assert(n == root.row());
 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) if (CPUAffinity::enabled())
+#endif
             for (int y = 0; y < threads; ++y) {
+                CPUAffinity affinity;
+                affinity.bind(y);
+                localize(specs, y);
                 snodeTables[y].resize(n + 1);
                 pools[y].resize(n + 1);
             }
@@ -1052,14 +1605,19 @@ public:
         MyVector<size_t> nodeColumn(m);
         int lowestChild = i - 1;
         size_t deadCount = 0;
+        size_t states = 0;
+        size_t slots = 0;
+        size_t probes = 0;
 
 #ifdef _OPENMP
         // OpenMP 2.0 does not support reduction(min:lowestChild)
-#pragma omp parallel reduction(+:deadCount)
+#pragma omp parallel reduction(+:deadCount,states,slots,probes)
 #endif
         {
 #ifdef _OPENMP
             int yy = omp_get_thread_num();
+            CPUAffinity affinity;
+            affinity.bind(yy);
 #else
             int yy = 0;
 #endif
@@ -1107,6 +1665,9 @@ public:
                 }
 
                 nodeColumn[j] = jj;
+                states += mm;
+                slots += uniq.tableSize();
+                probes += uniq.collisions();
             }
 
 #ifdef _OPENMP
@@ -1214,7 +1775,43 @@ public:
             if (lc < lowestChild) lowestChild = lc;
         }
 
-        sweeper.update(i, lowestChild, deadCount);
+        stats.states = states;
+        stats.unique = stats.nodes = output[i].size();
+        stats.dead = deadCount;
+        stats.slots = slots;
+        stats.probes = probes;
+        stats.swept = sweeper.update(i, lowestChild, deadCount);
+    }
+
+    /**
+     * Destructs the states scheduled below a level
+     * in order to abandon the construction.
+     * @param i the last level built.
+     */
+    void destructPending(int i) {
+        for (int y = 0; y < threads; ++y) {
+            MyVector<MyVector<MyListOnPool<SpecNode> > >& table =
+                    snodeTables[y];
+            for (int k = std::min(i, int(table.size())) - 1; k >= 0; --k) {
+                for (size_t j = 0; j < table[k].size(); ++j) {
+                    MyListOnPool<SpecNode>& list = table[k][j];
+                    for (MyListOnPool<SpecNode>::iterator t = list.begin();
+                            t != list.end(); ++t) {
+                        specs[y].destruct(state(*t));
+                    }
+                }
+                table[k].clear();
+                pools[y][k].clear();
+            }
+        }
+    }
+
+    /**
+     * Gets the counters of the last level built.
+     * @return the counters.
+     */
+    LevelStats const& levelStats() const {
+        return stats;
     }
 
 private:
@@ -0,0 +1,491 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "DdTransport.hpp"
+#include "Node.hpp"
+#include "NodeTable.hpp"
+#include "../DdSpec.hpp"
+#include "../util/MyHashTable.hpp"
+#include "../util/MyList.hpp"
+#include "../util/MyVector.hpp"
+#include "../util/Telemetry.hpp"
+
+namespace tdzdd {
+
+/**
+ * Breadth-first DD builder distributed over processes.
+ * The states of each level are partitioned by their hash codes and
+ * each process owns a slice of every output row.
+ * A node in a slice is identified globally by its row, its owner and
+ * its column in the slice; the column of the global node ID is
+ * the local column times the number of processes plus the owner.
+ *
+ * Each level is built in one all-to-all exchange: the owner of the
+ * level deduplicates the states it has received, returns the node IDs
+ * to the parents, and sends the child states to their owners.
+ * The states are copied byte-wise between processes, so they must not
+ * own memory, and merge_states is not used.
+ */
+template<typename S>
+class DdBuilderDist {
+    typedef S Spec;
+    typedef uint64_t Word;
+    static int const AR = Spec::ARITY;
+    static int const headerSize = 3;
+
+    /* SpecNode
+     * ┌────────┬────────┬────────┬────────┬────────┬─────
+     * │ branch │ source │  hash  │state[0]│state[1]│ ...
+     * └────────┴────────┴────────┴────────┴────────┴─────
+     * branch: the parent row and the parent column times ARITY plus
+     *         the branch value, or 0 for the root.
+     * source: the rank of the parent's owner, or ~0 for a duplicate.
+     * hash:   the hash code of the state computed by the sender.
+     */
+    static Word& branch(Word* p) {
+        return p[0];
+    }
+
+    static Word& source(Word* p) {
+        return p[1];
+    }
+
+    static Word& hash(Word* p) {
+        return p[2];
+    }
+
+    static Word hash(Word const* p) {
+        return p[2];
+    }
+
+    static void* state(Word* p) {
+        return p + headerSize;
+    }
+
+    static void const* state(Word const* p) {
+        return p + headerSize;
+    }
+
+    struct Hasher {
+        Spec const& spec;
+        int const level;
+
+        Hasher(Spec const& spec, int level) :
+                spec(spec), level(level) {
+        }
+
+        size_t operator()(Word const* p) const {
+            return hash(p);
+        }
+
+        size_t operator()(Word const* p, Word const* q) const {
+            return spec.equal_to(state(p), state(q), level);
+        }
+    };
+
+    typedef MyHashTable<Word*,Hasher,Hasher> UniqTable;
+
+    Spec spec;
+    DdTransport& transport;
+    int const rank;
+    int const procs;
+    int const stateWords;
+    int const specNodeSize;
+    NodeTableHandler<AR> output;
+    MyVector<MyList<Word> > snodeTable;
+    MyVector<Word> scratch;
+    std::vector<std::string> msgs;
+    NodeId root;
+    bool hasRoot;
+    MyVector<MyVector<size_t> > offset;
+    LevelStats stats;
+
+    static void put(std::string& s, Word w) {
+        s.append(reinterpret_cast<char const*>(&w), sizeof(w));
+    }
+
+    static Word get(char const* p) {
+        Word w;
+        std::memcpy(&w, p, sizeof(w));
+        return w;
+    }
+
+    int owner(Word h) const {
+        return (h * 314159257ULL >> 32) % procs;
+    }
+
+    NodeId globalToLocal(NodeId f) const {
+        int const i = f.row();
+        if (i == 0) return f;
+        size_t const col = f.col();
+        return NodeId(i, offset[i][col % procs] + col / procs);
+    }
+
+    void reply(Word* p, NodeId f) {
+        Word w[2] = { branch(p), f.code() };
+        msgs[source(p)].append(reinterpret_cast<char const*>(w), sizeof(w));
+    }
+
+    void receive(std::string const& msg, int src) {
+        char const* p = msg.data();
+        char const* const end = p + msg.size();
+        size_t const recordSize = specNodeSize * sizeof(Word);
+        if (p == end) return;
+
+        NodeTableEntity<AR>& out = output.privateEntity();
+        Word numReplies = get(p);
+        p += sizeof(Word);
+        for (Word k = 0; k < numReplies; ++k, p += 2 * sizeof(Word)) {
+            NodeId const b = get(p);
+            NodeId const f = get(p + sizeof(Word));
+            if (b.code() == 0) {
+                root = f;
+                hasRoot = true;
+            }
+            else {
+                out[b.row()][b.col() / AR].branch[b.col() % AR] = f;
+            }
+        }
+
+        for (; p < end; p += recordSize) {
+            int const level = get(p);
+            Word* q = snodeTable[level].alloc_front(specNodeSize);
+            branch(q) = get(p + sizeof(Word));
+            source(q) = src;
+            hash(q) = get(p + 2 * sizeof(Word));
+            std::memcpy(state(q), p + 3 * sizeof(Word),
+                    stateWords * sizeof(Word));
+        }
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param spec the spec, of which every process has the same copy.
+     * @param transport the transport of this process.
+     */
+    DdBuilderDist(Spec const& spec, DdTransport& transport) :
+            spec(spec),
+            transport(transport),
+            rank(transport.rank()),
+            procs(transport.size()),
+            stateWords((spec.datasize() + sizeof(Word) - 1) / sizeof(Word)),
+            specNodeSize(headerSize + stateWords),
+            scratch(specNodeSize),
+            msgs(procs),
+            root(0),
+            hasRoot(false) {
+        if (spec.datasize() < 0)
+            throw std::runtime_error("storage size is not initialized!!!");
+    }
+
+    /**
+     * Initializes the builder.
+     * Every process computes the root state and only its owner keeps it.
+     * @return the number of levels.
+     */
+    int initialize() {
+        void* const s = scratch.data();
+        int n = spec.get_root(s);
+
+        if (n <= 0) {
+            root = n ? 1 : 0;
+            hasRoot = rank == 0;
+            n = 0;
+        }
+        else {
+            output = NodeTableHandler<AR>(n + 1);
+            snodeTable.resize(n + 1);
+            Word h = spec.hash_code(s, n);
+            if (owner(h) == rank) {
+                Word* p = snodeTable[n].alloc_front(specNodeSize);
+                branch(p) = 0;
+                source(p) = rank;
+                hash(p) = h;
+                std::memcpy(state(p), s, stateWords * sizeof(Word));
+            }
+        }
+
+        return n;
+    }
+
+    /**
+     * Builds the slice of one level and posts the messages.
+     * collect() must be called before building the next level.
+     * @param i level.
+     */
+    void construct(int i) {
+        assert(0 < i && size_t(i) < snodeTable.size());
+        MyList<Word>& snodes = snodeTable[i];
+        size_t m = 0;
+        stats.clear();
+        stats.states = snodes.size();
+
+        msgs.resize(procs);
+        for (int k = 0; k < procs; ++k) {
+            msgs[k].clear();
+            put(msgs[k], 0); // the number of replies
+        }
+
+        {
+            Hasher hasher(spec, i);
+            UniqTable uniq(snodes.size() * 2, hasher, hasher);
+
+            for (MyList<Word>::iterator t = snodes.begin();
+                    t != snodes.end(); ++t) {
+                Word* p = *t;
+                Word*& p0 = uniq.add(p);
+
+                if (p0 == p) {
+                    Word col = m++ * procs + rank;
+                    reply(p, NodeId(i, col));
+                    source(p) = col; // referred to by the duplicates
+                }
+                else {
+                    reply(p, NodeId(i, source(p0)));
+                    source(p) = ~Word(0);
+                }
+            }
+
+            stats.slots = uniq.tableSize();
+            stats.probes = uniq.collisions();
+        }
+
+        for (int k = 0; k < procs; ++k) {
+            Word numReplies = (msgs[k].size() - sizeof(Word))
+                    / (2 * sizeof(Word));
+            std::memcpy(&msgs[k][0], &numReplies, sizeof(Word));
+        }
+
+        stats.unique = stats.nodes = m;
+        NodeTableEntity<AR>& out = output.privateEntity();
+        out.initRow(i, m);
+        Node<AR>* const outi = out[i].data();
+        size_t jj = 0;
+        void* const s = scratch.data() + headerSize;
+
+        for (; !snodes.empty(); snodes.pop_front()) {
+            Word* p = snodes.front();
+
+            if (source(p) == ~Word(0)) {
+                spec.destruct(state(p));
+                continue;
+            }
+
+            Node<AR>& q = outi[jj];
+            assert(source(p) == jj * procs + rank);
+
+            for (int b = 0; b < AR; ++b) {
+                spec.get_copy(s, state(p));
+                int ii = spec.get_child(s, i, b);
+
+                if (ii <= 0) {
+                    q.branch[b] = ii ? 1 : 0;
+                }
+                else {
+                    Word* w = scratch.data();
+                    w[0] = ii;
+                    w[1] = NodeId(i, jj * AR + b).code();
+                    w[2] = spec.hash_code(s, ii);
+                    msgs[owner(w[2])].append(
+                            reinterpret_cast<char const*>(w),
+                            specNodeSize * sizeof(Word));
+                }
+                spec.destruct(s);
+            }
+
+            spec.destruct(state(p));
+            ++jj;
+        }
+
+        spec.destructLevel(i);
+        transport.post(msgs);
+    }
+
+    /**
+     * Collects the messages posted by construct().
+     */
+    void collect() {
+        transport.collect(msgs);
+        for (int k = 0; k < procs; ++k) {
+            receive(msgs[k], k);
+            msgs[k].clear(); // the buffers are reused for the next level
+        }
+    }
+
+    /**
+     * Gets the counters of the last level built.
+     * @return the counters.
+     */
+    LevelStats const& levelStats() const {
+        return stats;
+    }
+
+    /**
+     * Posts the slice of an output row to rank 0.
+     * The rows are gathered bottom-up one by one so that rank 0 keeps
+     * little more than the result; collectSlice() must be called next.
+     * @param i level.
+     */
+    void postSlice(int i) {
+        MyVector<Node<AR> >& row = output.privateEntity()[i];
+        msgs.assign(procs, std::string());
+        msgs[0].assign(reinterpret_cast<char const*>(row.data()),
+                row.size() * sizeof(Node<AR>));
+        row.clear();
+        transport.post(msgs);
+    }
+
+    /**
+     * Collects the slices of an output row on rank 0 and renumbers
+     * the nodes.
+     * @param i level.
+     * @param table the node table to make on rank 0.
+     */
+    void collectSlice(int i, NodeTableEntity<AR>& table) {
+        transport.collect(msgs);
+        if (rank == 0) {
+            if (offset.empty()) offset.resize(table.numRows());
+            MyVector<size_t>& off = offset[i];
+            off.resize(procs + 1);
+            off[0] = 0;
+            for (int k = 0; k < procs; ++k) {
+                off[k + 1] = off[k] + msgs[k].size() / sizeof(Node<AR>);
+            }
+
+            table.initRow(i, off[procs]);
+            Node<AR>* q = table[i].data();
+            for (int k = 0; k < procs; ++k) {
+                size_t const m = msgs[k].size() / sizeof(Node<AR>);
+                std::memcpy(q, msgs[k].data(), msgs[k].size());
+                std::string().swap(msgs[k]);
+                for (size_t j = 0; j < m; ++j, ++q) {
+                    for (int b = 0; b < AR; ++b) {
+                        q->branch[b] = globalToLocal(q->branch[b]);
+                    }
+                }
+            }
+        }
+        msgs.clear();
+    }
+
+    /**
+     * Posts the root node to rank 0 after all the slices are gathered.
+     * collectRoot() must be called next.
+     */
+    void postRoot() {
+        msgs.assign(procs, std::string());
+        if (hasRoot) put(msgs[0], root.code());
+        transport.post(msgs);
+    }
+
+    /**
+     * Collects the root node on rank 0.
+     * The other processes get the 0-terminal.
+     * @param rootId the root node of the result.
+     */
+    void collectRoot(NodeId& rootId) {
+        transport.collect(msgs);
+        rootId = 0;
+        if (rank == 0) {
+            for (int k = 0; k < procs; ++k) {
+                if (msgs[k].empty()) continue;
+                rootId = globalToLocal(get(msgs[k].data()));
+            }
+        }
+        msgs.clear();
+        offset.clear();
+    }
+};
+
+/**
+ * DdBuilderDist objects for all the endpoints of a local transport,
+ * which are deleted with this object.
+ */
+template<typename S>
+class DdBuilderDistGroup {
+    std::vector<DdBuilderDist<S>*> builders;
+
+    void clear() {
+        while (!builders.empty()) {
+            delete builders.back();
+            builders.pop_back();
+        }
+    }
+
+    DdBuilderDistGroup(DdBuilderDistGroup const&);
+    DdBuilderDistGroup& operator=(DdBuilderDistGroup const&);
+
+public:
+    /**
+     * Constructor.
+     * @param spec DD spec.
+     * @param transport the local transport.
+     */
+    DdBuilderDistGroup(S const& spec, LocalTransport& transport) {
+        builders.reserve(transport.size());
+        try {
+            for (int k = 0; k < transport.size(); ++k) {
+                builders.push_back(new DdBuilderDist<S>(spec, transport[k]));
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    ~DdBuilderDistGroup() {
+        clear();
+    }
+
+    /**
+     * Gets the number of builders.
+     * @return the number of builders.
+     */
+    int size() const {
+        return builders.size();
+    }
+
+    /**
+     * Gets the builder of an endpoint.
+     * @param k the rank of the endpoint.
+     * @return the builder.
+     */
+    DdBuilderDist<S>& operator[](int k) {
+        return *builders[k];
+    }
+};
+
+} // namespace tdzdd
@@ -0,0 +1,381 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "DataTable.hpp"
+#include "Node.hpp"
+#include "NodeTable.hpp"
+#include "../util/CPUAffinity.hpp"
+#include "../util/MyHashTable.hpp"
+#include "../util/MyList.hpp"
+#include "../util/MyVector.hpp"
+
+namespace tdzdd {
+
+/**
+ * Bottom-up converter between BDDs and ZDDs.
+ * The input diagram is read as a BDD when the target is a ZDD and
+ * as a ZDD when the target is a BDD.
+ * Each input node is expanded into a chain of nodes for the levels
+ * that the input skips and the output needs, and output nodes are
+ * shared level by level, so that the result is already reduced.
+ * @tparam ARITY arity of the nodes.
+ * @tparam BDD convert into a BDD.
+ * @tparam ZDD convert into a ZDD.
+ */
+template<int ARITY, bool BDD, bool ZDD>
+class DdConverter {
+    NodeTableEntity<ARITY> const& input;
+    NodeTableEntity<ARITY>& output;
+    int const numVars;
+    int topLevel;
+    NodeId inputRoot;
+    NodeId* rootPtr;
+
+    DataTable<int> needLevel;     ///< The highest output level to be made.
+    DataTable<NodeId> newId;      ///< Output node at the current level.
+    MyVector<MyVector<int> > expiredRows; ///< Rows released at each level.
+    MyVector<NodeId> chains;      ///< Input nodes being extended upward.
+
+#ifdef _OPENMP
+    static int const TASKS_PER_THREAD = 10;
+
+    int const threads;
+    int const tasks;
+    MyVector<MyVector<MyList<size_t> > > taskMatrix;
+    MyVector<size_t> baseColumn;
+#endif
+
+    MyVector<Node<ARITY> > cand;
+    MyVector<NodeId> result;
+
+public:
+    /**
+     * Constructor.
+     * @param input the input diagram.
+     * @param output the output diagram.
+     * @param numVars the number of variables.
+     */
+    DdConverter(NodeTableHandler<ARITY> const& input,
+                NodeTableHandler<ARITY>& output, int numVars) :
+            input(*input),
+            output(output.privateEntity()),
+            numVars(numVars),
+            topLevel(0),
+            inputRoot(0),
+            rootPtr(0)
+#ifdef _OPENMP
+            , threads(omp_get_max_threads()),
+            tasks(MyHashConstant::primeSize(TASKS_PER_THREAD * threads)),
+            taskMatrix(threads),
+            baseColumn(tasks + 1)
+#endif
+    {
+#ifdef _OPENMP
+        for (int y = 0; y < threads; ++y) {
+            taskMatrix[y].resize(tasks);
+        }
+#endif
+    }
+
+    /**
+     * Initializes the converter.
+     * @param root the root node, which is replaced by the new root later.
+     * @return the top level of the output.
+     */
+    int initialize(NodeId& root) {
+        rootPtr = &root;
+        inputRoot = root;
+        int const r = root.row();
+        topLevel = (root == 0) ? 0 : std::max(numVars, r);
+        output.init(topLevel + 1);
+
+        if (topLevel == 0) {
+            root = (root == 0) ? 0 : 1;
+            return 0;
+        }
+
+        needLevel.init(r + 1);
+        newId.init(r + 1);
+        expiredRows.resize(topLevel + 1);
+
+        for (int i = 0; i <= r; ++i) {
+            needLevel[i].resize(input[i].size());
+            for (size_t j = 0; j < needLevel[i].size(); ++j) {
+                needLevel[i][j] = -1;
+            }
+        }
+        needLevel[r][root.col()] = topLevel;
+
+        for (int i = r; i >= 1; --i) {
+            size_t const m = input[i].size();
+            int rowNeed = -1;
+
+            for (size_t j = 0; j < m; ++j) {
+                int const t = needLevel[i][j];
+                if (t < 0) continue;
+                if (rowNeed < t) rowNeed = t;
+
+                for (int b = 0; b < ARITY; ++b) {
+                    NodeId const f = input.child(i, j, b);
+                    if (f == 0) continue;
+                    int& tt = needLevel[f.row()][f.col()];
+                    if (tt < i - 1) tt = i - 1;
+                }
+            }
+
+            if (rowNeed >= 0) expiredRows[rowNeed].push_back(i);
+        }
+
+        newId[0].resize(2);
+        newId[0][0] = 0;
+        newId[0][1] = 1;
+        if (needLevel[0][1] >= 1) chains.push_back(1);
+        return topLevel;
+    }
+
+    /**
+     * Makes one level of the output.
+     * @param k level.
+     * @param useMP use an algorithm for multiple processors.
+     */
+    void convert(int k, bool useMP = false) {
+        assert(1 <= k && k <= topLevel);
+        size_t const m = (k < input.numRows()) ? input[k].size() : 0;
+        size_t const mc = chains.size();
+        if (m > 0) newId[k].resize(m);
+        cand.resize(m + mc);
+        result.resize(m + mc);
+
+#ifdef _OPENMP
+        if (useMP) {
+#pragma omp parallel for schedule(static)
+            for (intmax_t j = 0; j < intmax_t(m + mc); ++j) {
+                makeCandidate(k, j, m);
+            }
+            shareMP_(k);
+        }
+        else
+#endif
+        {
+            for (size_t j = 0; j < m + mc; ++j) {
+                makeCandidate(k, j, m);
+            }
+            share_(k);
+        }
+
+        MyVector<NodeId> next;
+        next.reserve(mc + m);
+
+        for (size_t t = 0; t < mc; ++t) {
+            NodeId const f = chains[t];
+            newId[f.row()][f.col()] = result[m + t];
+            if (needLevel[f.row()][f.col()] > k) next.push_back(f);
+        }
+
+        for (size_t j = 0; j < m; ++j) {
+            int const t = needLevel[k][j];
+            if (t < 0) continue;
+            newId[k][j] = result[j];
+            if (t > k) next.push_back(NodeId(k, j));
+        }
+
+        chains.swap(next);
+
+        MyVector<int> const& rows = expiredRows[k - 1];
+        for (int const* t = rows.begin(); t != rows.end(); ++t) {
+            newId[*t].clear();
+            needLevel[*t].clear();
+        }
+
+        if (k == topLevel) {
+            *rootPtr = newId[inputRoot.row()][inputRoot.col()];
+            cand.clear();
+            result.clear();
+            newId.init();
+            needLevel.init();
+            chains.clear();
+        }
+    }
+
+private:
+    /**
+     * Makes the j-th output candidate at level @p k.
+     * Candidates [0, m) are from the input nodes at level @p k and
+     * the others are from the chains.
+     * The result is the node ID to be forwarded or
+     * NodeId(k + 1, j) when the candidate should be shared.
+     */
+    void makeCandidate(int k, size_t j, size_t m) {
+        Node<ARITY>& q = cand[j];
+
+        if (j < m) {
+            if (needLevel[k][j] < 0) {
+                result[j] = 0;
+                return;
+            }
+
+            bool del = true;
+            for (int b = 0; b < ARITY; ++b) {
+                NodeId const f = input.child(k, j, b);
+                q.branch[b] = newId[f.row()][f.col()];
+                if (b >= 1 && q.branch[b] != (BDD ? q.branch[0] : NodeId(0))) {
+                    del = false;
+                }
+            }
+            result[j] = del ? q.branch[0] : NodeId(k + 1, j);
+        }
+        else {
+            NodeId const f = chains[j - m];
+            NodeId const f0 = newId[f.row()][f.col()];
+            if (f0 == 0) {
+                result[j] = 0;
+                return;
+            }
+
+            q.branch[0] = f0;
+            for (int b = 1; b < ARITY; ++b) {
+                q.branch[b] = BDD ? NodeId(0) : f0;
+            }
+            result[j] = NodeId(k + 1, j);
+        }
+    }
+
+    void share_(int k) {
+        size_t const n = cand.size();
+        MyHashTable<Node<ARITY> const*> uniq(n * 2);
+        Node<ARITY> const* const c0 = cand.data();
+        size_t mm = 0;
+
+        for (size_t j = 0; j < n; ++j) {
+            if (result[j].row() != k + 1) continue;
+            Node<ARITY> const* pp = uniq.add(&cand[j]);
+
+            if (pp == &cand[j]) {
+                result[j] = NodeId(k, mm++, cand[j].branch[0].hasEmpty());
+            }
+            else {
+                result[j] = result[pp - c0];
+            }
+        }
+
+        output.initRow(k, mm);
+
+        for (size_t j = 0; j < n; ++j) {
+            NodeId const f = result[j];
+            if (f.row() == k) output[k][f.col()] = cand[j];
+        }
+    }
+
+#ifdef _OPENMP
+    void shareMP_(int k) {
+        size_t const n = cand.size();
+
+#pragma omp parallel
+        {
+            int y = omp_get_thread_num();
+            CPUAffinity affinity;
+            affinity.bind(y);
+            MyHashTable<Node<ARITY> const*> uniq;
+            Node<ARITY> const* const c0 = cand.data();
+
+#pragma omp for schedule(static)
+            for (intmax_t j = 0; j < intmax_t(n); ++j) {
+                if (result[j].row() != k + 1) continue;
+                int x = cand[j].hash() % tasks;
+                *taskMatrix[y][x].alloc_front() = j;
+            }
+
+#pragma omp for schedule(dynamic)
+            for (int x = 0; x < tasks; ++x) {
+                size_t mm = 0;
+                for (int yy = 0; yy < threads; ++yy) {
+                    mm += taskMatrix[yy][x].size();
+                }
+                if (mm == 0) {
+                    baseColumn[x + 1] = 0;
+                    continue;
+                }
+
+                uniq.initialize(mm * 2);
+                size_t jj = 0;
+
+                for (int yy = 0; yy < threads; ++yy) {
+                    MyList<size_t>& taskq = taskMatrix[yy][x];
+
+                    for (MyList<size_t>::iterator t = taskq.begin();
+                            t != taskq.end(); ++t) {
+                        size_t const j = **t;
+                        Node<ARITY> const* pp = uniq.add(&cand[j]);
+
+                        if (pp == &cand[j]) {
+                            result[j] = NodeId(k + 1 + x, jj++,
+                                               cand[j].branch[0].hasEmpty()); // row += task ID
+                        }
+                        else {
+                            result[j] = result[pp - c0];
+                        }
+                    }
+                }
+
+                baseColumn[x + 1] = jj;
+            }
+
+            for (int x = 0; x < tasks; ++x) {
+                taskMatrix[y][x].clear();
+            }
+
+#pragma omp single
+            {
+                baseColumn[0] = 0;
+                for (int x = 0; x < tasks; ++x) {
+                    baseColumn[x + 1] += baseColumn[x];
+                }
+                output.initRow(k, baseColumn[tasks]);
+            }
+
+#pragma omp for schedule(static)
+            for (intmax_t j = 0; j < intmax_t(n); ++j) {
+                NodeId& f = result[j];
+                if (f.row() > k) {
+                    f = NodeId(k, f.col() + baseColumn[f.row() - k - 1],
+                               f.getAttr());
+                    output[k][f.col()] = cand[j];
+                }
+            }
+        }
+    }
+#endif
+};
+
+} // namespace tdzdd
@@ -35,9 +35,12 @@
 
 #include "Node.hpp"
 #include "NodeTable.hpp"
+#include "../util/CPUAffinity.hpp"
 #include "../util/MyHashTable.hpp"
 #include "../util/MyList.hpp"
 #include "../util/MyVector.hpp"
+#include "../util/PerfCounter.hpp"
+#include "../util/Telemetry.hpp"
 
 namespace tdzdd {
 
@@ -82,13 +85,23 @@ class DdReducer {
 #endif
 
     bool readyForSequentialReduction;
+    bool const inPlace;
+    LevelStats stats;
 
 public:
-    DdReducer(NodeTableHandler<ARITY>& diagram, bool useMP = false) :
+    /**
+     * Constructor.
+     * @param diagram the diagram to be reduced.
+     * @param useMP use an algorithm for multiple processors.
+     * @param inPlace overwrite the rows of @p diagram with the result
+     *        instead of making a new table.
+     */
+    DdReducer(NodeTableHandler<ARITY>& diagram, bool useMP = false,
+              bool inPlace = false) :
             input(diagram.privateEntity()),
             oldDiagram(diagram),
-            newDiagram(input.numRows()),
-            output(newDiagram.privateEntity()),
+            newDiagram(inPlace ? 1 : input.numRows()),
+            output(inPlace ? input : newDiagram.privateEntity()),
             newIdTable(input.numRows()),
             rootPtr(input.numRows()),
 #ifdef _OPENMP
@@ -97,7 +110,8 @@ public:
             taskMatrix(threads),
             baseColumn(tasks + 1),
 #endif
-            readyForSequentialReduction(false) {
+            readyForSequentialReduction(false),
+            inPlace(inPlace) {
 #ifdef _OPENMP
 #ifdef DEBUG
         if (useMP) {
@@ -107,7 +121,7 @@ public:
         etcS0.start();
 #endif
 #endif
-        diagram = newDiagram;
+        if (!inPlace) diagram = newDiagram;
 
         input.initTerminals();
         input.makeIndex(useMP);
@@ -117,8 +131,15 @@ public:
         newIdTable[0][1] = 1;
 
 #ifdef _OPENMP
-        for (int y = 0; y < threads; ++y) {
-            taskMatrix[y].resize(tasks);
+#ifdef __GNUC__
+        bool const usesTasks = !inPlace && ARITY != 2; // see reduce()
+#else
+        bool const usesTasks = !inPlace;
+#endif
+        if (usesTasks) {
+            for (int y = 0; y < threads; ++y) {
+                taskMatrix[y].resize(tasks);
+            }
         }
 #ifdef DEBUG
         etcS0.stop();
@@ -149,8 +170,9 @@ private:
      * Applies the node deletion rules.
      * It is required before serial reduction (Algorithm-R)
      * in order to make lower-level index safe.
+     * @param useMP use an algorithm for multiple processors.
      */
-    void makeReadyForSequentialReduction() {
+    void makeReadyForSequentialReduction(bool useMP = false) {
         if (readyForSequentialReduction) return;
 #ifdef DEBUG
         size_t dead = 0;
@@ -159,7 +181,14 @@ private:
             size_t const m = input[i].size();
             Node<ARITY>* const tt = input[i].data();
 
-            for (size_t j = 0; j < m; ++j) {
+#ifdef _OPENMP
+#ifdef DEBUG
+#pragma omp parallel for schedule(static) reduction(+:dead) if(useMP)
+#else
+#pragma omp parallel for schedule(static) if(useMP)
+#endif
+#endif
+            for (intmax_t j = 0; j < intmax_t(m); ++j) {
                 for (int b = 0; b < ARITY; ++b) {
                     NodeId& f = tt[j].branch[b];
                     if (f.row() == 0) continue;
@@ -187,7 +216,7 @@ private:
         MessageHandler mh;
         mh << "[#dead = " << dead << "]";
 #endif
-        input.makeIndex();
+        input.makeIndex(useMP);
         readyForSequentialReduction = true;
     }
 
@@ -206,7 +235,19 @@ public:
      * @param useMP use an algorithm for multiple processors.
      */
     void reduce(int i, bool useMP = false) {
-        if (useMP) {
+        PerfScope perf("reduce", i);
+        stats.clear();
+        stats.states = input[i].size();
+
+        if (inPlace) {
+            reduceInPlace_(i, useMP);
+        }
+#if defined(_OPENMP) && defined(__GNUC__)
+        else if (useMP && ARITY == 2) {
+            algorithmRMP_(i);
+        }
+#endif
+        else if (useMP) {
             reduceMP_(i);
         }
         else if (ARITY == 2) {
@@ -215,6 +256,21 @@ public:
         else {
             reduce_(i);
         }
+
+        stats.unique = stats.nodes = output[i].size();
+        MyVector<NodeId> const& newId = newIdTable[i];
+        for (size_t j = 0; j < newId.size(); ++j) {
+            if (newId[j].row() < i) ++stats.dead;
+        }
+    }
+
+    /**
+     * Gets the counters of the last level reduced.
+     * Nodes deleted by the node deletion rule are counted as dead.
+     * @return the counters.
+     */
+    LevelStats const& levelStats() const {
+        return stats;
     }
 
 private:
@@ -331,6 +387,150 @@ private:
         }
     }
 
+#if defined(_OPENMP) && defined(__GNUC__)
+    /**
+     * Reduces one level using a parallel version of Algorithm-R.
+     * Each node is pushed onto its f0-equivalent list by an atomic exchange
+     * on the list head, and the lists are distributed over the threads.
+     * The scratch field of a 1-child is claimed by the first list that
+     * touches it with compare-and-swap; other lists sharing the 1-child
+     * fall back on a thread-local hash table.
+     * @param i level.
+     */
+    void algorithmRMP_(int i) {
+        assert(ARITY == 2);
+        makeReadyForSequentialReduction(true);
+        size_t const m = input[i].size();
+        Node<ARITY>* const tt = input[i].data();
+        NodeId const tag(i + 1, 0); // row of the values written in this level
+
+        MyVector<NodeId>& newId = newIdTable[i];
+        newId.resize(m);
+        size_t mm = 0;
+
+#pragma omp parallel
+        {
+            int y = omp_get_thread_num();
+            CPUAffinity affinity;
+            affinity.bind(y);
+            MyHashMap<uint64_t,size_t> local;
+
+#pragma omp for schedule(static)
+            for (intmax_t j = 0; j < intmax_t(m); ++j) {
+                canonicalize(i, j);
+                if (newId[j].row() != tag.row()) continue;
+
+                // the head of f0-equivalent list is at the 0-child of f0
+                NodeId old = __sync_lock_test_and_set(
+                        word(input.child(tt[j].branch[0], 0)),
+                        NodeId(i + 1, j).code());
+                newId[j] = NodeId(i + 1, old.row() == tag.row() ? old.col() : m);
+            }
+
+#pragma omp single
+            {
+                MyVector<int> const& levels = input.lowerLevels(i);
+                for (int const* t = levels.begin(); t != levels.end(); ++t) {
+                    newIdTable[*t].clear();
+                }
+            }
+
+            size_t c = 0;
+
+#pragma omp for schedule(dynamic, 64)
+            for (intmax_t j = 0; j < intmax_t(m); ++j) {
+                NodeId const f0 = tt[j].branch[0];
+                NodeId const f1 = tt[j].branch[1];
+                if ((BDD && f1 == f0) || (ZDD && f1 == 0)) continue;
+                if (input.child(f0, 0) != NodeId(i + 1, j)) continue; // not a head
+
+                for (size_t k = j; k < m;) { // for each g in f0-equivalent list
+                    NodeId const g1 = tt[k].branch[1];
+                    uint64_t volatile* const g11 = word(input.child(g1, 1));
+                    size_t const next = newId[k].col();
+                    size_t owner = k;
+
+                    for (uint64_t w = *g11;;) {
+                        if (NodeId(w).row() == tag.row()) {
+                            owner = NodeId(w).col();
+                            break;
+                        }
+                        uint64_t const ww = __sync_val_compare_and_swap(
+                                g11, w, NodeId(i + 1, k).code());
+                        if (ww == w) break;
+                        w = ww;
+                    }
+
+                    if (owner != k && tt[owner].branch[0] != f0) {
+                        // g1 is claimed by another list
+                        size_t& v = local[g1.code() + 1];
+                        if (v == 0) v = k + 1;
+                        owner = v - 1;
+                    }
+
+                    newId[k] = (owner == k) ?
+                            NodeId(i + 1 + y, c++) : // row += thread ID
+                            NodeId(i, owner); // forwarded
+                    k = next;
+                }
+
+                if (!local.empty()) local.initialize(1);
+            }
+
+            baseColumn[y + 1] = c;
+#pragma omp barrier
+
+#pragma omp single
+            {
+                int const n = omp_get_num_threads();
+                baseColumn[0] = 0;
+                for (int yy = 0; yy < n; ++yy) {
+                    baseColumn[yy + 1] += baseColumn[yy];
+                }
+                mm = baseColumn[n];
+
+                if (!BDD) {
+                    MyVector<int> const& levels = input.lowerLevels(i);
+                    for (int const* t = levels.begin(); t != levels.end(); ++t) {
+                        input[*t].clear();
+                    }
+                }
+
+                output.initRow(i, mm);
+            }
+
+#pragma omp for schedule(static)
+            for (intmax_t j = 0; j < intmax_t(m); ++j) {
+                if (newId[j].row() != i) continue;
+                NodeId const f = newId[newId[j].col()];
+                assert(f.row() > i);
+                newId[j] = NodeId(i, baseColumn[f.row() - i - 1] + f.col(),
+                                  tt[j].branch[0].hasEmpty());
+            }
+
+            Node<ARITY>* nt = output[i].data();
+
+#pragma omp for schedule(static)
+            for (intmax_t j = 0; j < intmax_t(m); ++j) {
+                NodeId const f = newId[j];
+                if (f.row() <= i) continue;
+                size_t k = baseColumn[f.row() - i - 1] + f.col();
+                newId[j] = NodeId(i, k, tt[j].branch[0].hasEmpty());
+                nt[k] = tt[j];
+            }
+        }
+
+        for (size_t k = 0; k < rootPtr[i].size(); ++k) {
+            NodeId& root = *rootPtr[i][k];
+            root = newId[root.col()];
+        }
+    }
+
+    static uint64_t volatile* word(NodeId& f) {
+        return reinterpret_cast<uint64_t volatile*>(&f);
+    }
+#endif
+
     /**
      * Reduces one level.
      * @param i level.
@@ -374,6 +574,9 @@ private:
                     }
                 }
             }
+
+            stats.slots = uniq.tableSize();
+            stats.probes = uniq.collisions();
         }
 
         MyVector<int> const& levels = input.lowerLevels(i);
@@ -398,6 +601,95 @@ private:
         }
     }
 
+    /**
+     * Reduces one level in place.
+     * Surviving nodes are packed to the front of the row in their original
+     * order, so that no second row is needed.
+     * @param i level.
+     * @param useMP use an algorithm for multiple processors.
+     */
+    void reduceInPlace_(int i, bool useMP) {
+        size_t const m = input[i].size();
+        Node<ARITY>* const tt = input[i].data();
+        MyVector<NodeId>& newId = newIdTable[i];
+        newId.resize(m);
+
+#ifdef _OPENMP
+        if (useMP)
+#pragma omp parallel for schedule(static)
+        for (intmax_t j = 0; j < intmax_t(m); ++j) {
+            canonicalize(i, j);
+        }
+        else
+#endif
+        for (size_t j = 0; j < m; ++j) {
+            canonicalize(i, j);
+        }
+
+        MyVector<int> const& levels = input.lowerLevels(i);
+        for (int const* t = levels.begin(); t != levels.end(); ++t) {
+            newIdTable[*t].clear();
+        }
+
+        size_t jj = 0;
+
+        {
+            MyHashTable<Node<ARITY> const*> uniq(m * 2);
+
+            for (size_t j = 0; j < m; ++j) {
+                if (newId[j].row() != i + 1) continue;
+                Node<ARITY> const* pp = uniq.add(&tt[j]);
+
+                if (pp == &tt[j]) {
+                    newId[j] = NodeId(i, jj++, tt[j].branch[0].hasEmpty());
+                }
+                else {
+                    newId[j] = newId[pp - tt];
+                }
+            }
+
+            stats.slots = uniq.tableSize();
+            stats.probes = uniq.collisions();
+        }
+
+        for (size_t j = 0, k = 0; j < m; ++j) {
+            NodeId const& ff = newId[j];
+            if (ff.row() == i && ff.col() == k) tt[k++] = tt[j];
+        }
+
+        input[i].resize(jj); // reallocated if much shorter
+
+        for (size_t k = 0; k < rootPtr[i].size(); ++k) {
+            NodeId& root = *rootPtr[i][k];
+            root = newId[root.col()];
+        }
+
+        // the level index of the unreduced diagram is no longer valid
+        if (i == input.numRows() - 1) input.deleteIndex();
+    }
+
+    /**
+     * Replaces the children of a node with the reduced ones and applies
+     * the node deletion rules.
+     * The node ID is set to the forwarded one if the node is deleted, or
+     * NodeId(i + 1, j) otherwise.
+     * @param i level.
+     * @param j column.
+     */
+    void canonicalize(int i, size_t j) {
+        Node<ARITY>& f = input[i][j];
+        NodeId& f0 = f.branch[0];
+        f0 = newIdTable[f0.row()][f0.col()];
+        NodeId deletable = BDD ? f0 : 0;
+        bool del = BDD || ZDD || (f0 == 0);
+        for (int b = 1; b < ARITY; ++b) {
+            NodeId& ff = f.branch[b];
+            ff = newIdTable[ff.row()][ff.col()];
+            if (ff != deletable) del = false;
+        }
+        newIdTable[i][j] = del ? f0 : NodeId(i + 1, j);
+    }
+
     /**
      * Reduces one level using OpenMP.
      * @param i level.
@@ -416,9 +708,14 @@ private:
         etcP1.start();
 #endif
 
-#pragma omp parallel
+        size_t slots = 0;
+        size_t probes = 0;
+
+#pragma omp parallel reduction(+:slots,probes)
         {
             int y = omp_get_thread_num();
+            CPUAffinity affinity;
+            affinity.bind(y);
             MyHashTable<ReducNodeInfo const*> uniq;
 
 #pragma omp for schedule(static)
@@ -500,6 +797,8 @@ private:
                 }
 
                 baseColumn[x + 1] = j;
+                slots += uniq.tableSize();
+                probes += uniq.collisions();
             }
 
             for (int x = 0; x < tasks; ++x) {
@@ -548,6 +847,8 @@ private:
         etcP3.stop();
         etcS4.start();
 #endif
+        stats.slots = slots;
+        stats.probes = probes;
         input[i].clear();
 
         for (size_t k = 0; k < rootPtr[i].size(); ++k) {
@@ -88,11 +88,12 @@ public:
      * @param current current level.
      * @param child the level at which edges from this level are completed.
      * @param count the number of dead nodes at this level.
+     * @return the number of nodes removed.
      */
-    void update(int current, int child, size_t count) {
+    size_t update(int current, int child, size_t count) {
         assert(1 <= current);
         assert(0 <= child);
-        if (current <= 1) return;
+        if (current <= 1) return 0;
 
         if (size_t(current) >= sweepLevel.size()) {
             sweepLevel.resize(current + 1);
@@ -113,9 +114,10 @@ public:
             deadCount[i] = 0;
         }
         if (maxCount < allCount) maxCount = allCount;
-        if (deadCount[k] * SWEEP_RATIO < maxCount) return;
+        if (deadCount[k] * SWEEP_RATIO < maxCount) return 0;
 
         MyVector<MyVector<NodeId> > newId(diagram.numRows());
+        size_t const oldSize = diagram.size();
 
         MessageHandler mh;
         mh.begin("sweeping") << " <" << diagram.size() << "> ...";
@@ -164,6 +166,7 @@ public:
         deadCount[k] = 0;
         allCount = diagram.size();
         mh.end(diagram.size());
+        return oldSize - diagram.size();
     }
 };
 
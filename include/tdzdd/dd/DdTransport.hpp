@@ -0,0 +1,352 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace tdzdd {
+
+/**
+ * Message passing between the processes of a distributed DD operation.
+ * Messages are exchanged all-to-all in two phases: every process posts
+ * one message to each process including itself, and then collects one
+ * message from each process.
+ */
+class DdTransport {
+public:
+    virtual ~DdTransport() {
+    }
+
+    /**
+     * Gets the ID of this process.
+     * @return the rank from 0 to size() - 1.
+     */
+    virtual int rank() const = 0;
+
+    /**
+     * Gets the number of processes.
+     * @return the number of processes.
+     */
+    virtual int size() const = 0;
+
+    /**
+     * Posts messages.
+     * @param msgs the message to each rank, which may be left empty.
+     */
+    virtual void post(std::vector<std::string>& msgs) = 0;
+
+    /**
+     * Collects the messages posted to this process.
+     * @param msgs the message from each rank.
+     */
+    virtual void collect(std::vector<std::string>& msgs) = 0;
+};
+
+/**
+ * Transport among the endpoints in one process.
+ * The endpoints must be driven in lockstep: every endpoint posts before
+ * any endpoint collects.
+ */
+class LocalTransport {
+    class Endpoint: public DdTransport {
+        std::vector<std::vector<std::string> >* box;
+        int rank_;
+
+    public:
+        Endpoint(std::vector<std::vector<std::string> >& box, int rank) :
+                box(&box), rank_(rank) {
+        }
+
+        int rank() const {
+            return rank_;
+        }
+
+        int size() const {
+            return box->size();
+        }
+
+        void post(std::vector<std::string>& msgs) {
+            msgs.resize(size());
+            for (int k = 0; k < size(); ++k) {
+                (*box)[rank_][k].swap(msgs[k]);
+                msgs[k].clear();
+            }
+        }
+
+        void collect(std::vector<std::string>& msgs) {
+            msgs.resize(size());
+            for (int k = 0; k < size(); ++k) {
+                msgs[k].clear();
+                msgs[k].swap((*box)[k][rank_]);
+            }
+        }
+    };
+
+    std::vector<std::vector<std::string> > box;
+    std::vector<Endpoint> endpoints;
+
+    LocalTransport(LocalTransport const&);
+    LocalTransport& operator=(LocalTransport const&);
+
+public:
+    /**
+     * Constructor.
+     * @param n the number of endpoints.
+     */
+    explicit LocalTransport(int n) :
+            box(n, std::vector<std::string>(n)) {
+        if (n < 1) throw std::runtime_error("No endpoint");
+        for (int k = 0; k < n; ++k) {
+            endpoints.push_back(Endpoint(box, k));
+        }
+    }
+
+    /**
+     * Gets the number of endpoints.
+     * @return the number of endpoints.
+     */
+    int size() const {
+        return endpoints.size();
+    }
+
+    /**
+     * Gets an endpoint.
+     * @param k the rank of the endpoint.
+     * @return the endpoint.
+     */
+    DdTransport& operator[](int k) {
+        return endpoints[k];
+    }
+};
+
+#ifndef _WIN32
+/**
+ * Transport among local processes over UNIX domain sockets.
+ * Each message is sent with its length in 8 bytes.
+ * Writes and reads are multiplexed by poll(2) so that the exchange
+ * of large messages does not deadlock.
+ */
+class SocketTransport: public DdTransport {
+    int rank_;
+    std::vector<int> fds;
+    std::vector<pid_t> children;
+    std::vector<std::string> outbox;
+
+    SocketTransport(SocketTransport const&);
+    SocketTransport& operator=(SocketTransport const&);
+
+    static void fail(char const* what) {
+        throw std::runtime_error(std::string(what) + ": " + strerror(errno));
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param rank the rank of this process.
+     * @param fds the stream socket connected to each rank,
+     *        or -1 for this process; they are closed by the destructor.
+     */
+    SocketTransport(int rank, std::vector<int> const& fds) :
+            rank_(rank), fds(fds), outbox(fds.size()) {
+    }
+
+    /**
+     * Forks worker processes connected with each other.
+     * The calling process becomes rank 0 and waits for the others
+     * on destruction of its transport, while the others should call
+     * _exit(2) after their work.
+     * @param n the number of processes.
+     * @return the transport of the process.
+     */
+    static SocketTransport* fork(int n) {
+        if (n < 1) throw std::runtime_error("No process");
+        std::vector<std::vector<int> > fd(n, std::vector<int>(n, -1));
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                int sv[2];
+                if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+                    fail("socketpair");
+                fd[i][j] = sv[0];
+                fd[j][i] = sv[1];
+            }
+        }
+
+        std::vector<pid_t> pids;
+        int rank = 0;
+        for (int k = 1; k < n; ++k) {
+            pid_t pid = ::fork();
+            if (pid < 0) fail("fork");
+            if (pid == 0) {
+                rank = k;
+                pids.clear();
+                break;
+            }
+            pids.push_back(pid);
+        }
+
+        for (int i = 0; i < n; ++i) {
+            if (i == rank) continue;
+            for (int j = 0; j < n; ++j) {
+                if (fd[i][j] >= 0) ::close(fd[i][j]);
+            }
+        }
+
+        SocketTransport* t = new SocketTransport(rank, fd[rank]);
+        t->children.swap(pids);
+        return t;
+    }
+
+    ~SocketTransport() {
+        for (size_t k = 0; k < fds.size(); ++k) {
+            if (fds[k] >= 0) ::close(fds[k]);
+        }
+        for (size_t k = 0; k < children.size(); ++k) {
+            int status;
+            ::waitpid(children[k], &status, 0);
+        }
+    }
+
+    int rank() const {
+        return rank_;
+    }
+
+    int size() const {
+        return fds.size();
+    }
+
+    void post(std::vector<std::string>& msgs) {
+        msgs.resize(size());
+        for (int k = 0; k < size(); ++k) {
+            if (k == rank_) {
+                outbox[k].swap(msgs[k]);
+            }
+            else {
+                uint64_t len = msgs[k].size();
+                outbox[k].assign(reinterpret_cast<char*>(&len), sizeof(len));
+                outbox[k].append(msgs[k]);
+            }
+            msgs[k].clear();
+        }
+    }
+
+    void collect(std::vector<std::string>& msgs) {
+        int const n = size();
+#ifdef MSG_NOSIGNAL
+        int const flags = MSG_DONTWAIT | MSG_NOSIGNAL;
+#else
+        int const flags = MSG_DONTWAIT;
+#endif
+        std::vector<size_t> sent(n);
+        std::vector<size_t> got(n);
+        std::vector<uint64_t> len(n);
+        std::vector<pollfd> pfd;
+        std::vector<int> peer;
+
+        msgs.resize(n);
+        msgs[rank_].swap(outbox[rank_]);
+        outbox[rank_].clear();
+        for (int k = 0; k < n; ++k) {
+            if (k != rank_) msgs[k].clear();
+        }
+
+        for (;;) {
+            pfd.clear();
+            peer.clear();
+            for (int k = 0; k < n; ++k) {
+                if (k == rank_) continue;
+                short events = 0;
+                if (sent[k] < outbox[k].size()) events |= POLLOUT;
+                if (got[k] < sizeof(uint64_t) + msgs[k].size()) {
+                    events |= POLLIN;
+                }
+                if (events == 0) continue;
+                pollfd p = { fds[k], events, 0 };
+                pfd.push_back(p);
+                peer.push_back(k);
+            }
+            if (pfd.empty()) break;
+
+            if (::poll(&pfd[0], pfd.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                fail("poll");
+            }
+
+            for (size_t t = 0; t < pfd.size(); ++t) {
+                int const k = peer[t];
+                if (pfd[t].revents & POLLOUT) {
+                    ssize_t r = ::send(fds[k], outbox[k].data() + sent[k],
+                            outbox[k].size() - sent[k], flags);
+                    if (r < 0 && errno != EAGAIN && errno != EINTR)
+                        fail("send");
+                    if (r > 0) sent[k] += r;
+                }
+                if (pfd[t].revents & (POLLIN | POLLHUP | POLLERR)) {
+                    ssize_t r;
+                    if (got[k] < sizeof(uint64_t)) {
+                        char* p = reinterpret_cast<char*>(&len[k]);
+                        r = ::recv(fds[k], p + got[k],
+                                sizeof(uint64_t) - got[k], flags);
+                    }
+                    else {
+                        size_t off = got[k] - sizeof(uint64_t);
+                        r = ::recv(fds[k], &msgs[k][off],
+                                msgs[k].size() - off, flags);
+                    }
+                    if (r == 0) throw std::runtime_error("Connection closed");
+                    if (r < 0 && errno != EAGAIN && errno != EINTR)
+                        fail("recv");
+                    if (r > 0) {
+                        bool header = got[k] < sizeof(uint64_t);
+                        got[k] += r;
+                        if (header && got[k] == sizeof(uint64_t)) {
+                            msgs[k].resize(len[k]);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (int k = 0; k < n; ++k) {
+            if (k != rank_) outbox[k].clear();
+        }
+    }
+};
+#endif
+
+} // namespace tdzdd
@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include <ostream>
 
+#include "../util/MemoryAccounting.hpp"
+
 namespace tdzdd {
 
 int const NODE_ROW_BITS = 20;
@@ -196,6 +198,17 @@ struct Node {
     }
 };
 
+/**
+ * Node arrays are accounted as the rows of node tables.
+ */
+template<int ARITY>
+struct MemoryAccounting::VectorKind<Node<ARITY> > {
+    static Kind const value = ROWS;
+};
+
+template<int ARITY>
+MemoryAccounting::Kind const MemoryAccounting::VectorKind<Node<ARITY> >::value;
+
 template<int ARITY>
 struct InitializedNode: Node<ARITY> {
     InitializedNode() :
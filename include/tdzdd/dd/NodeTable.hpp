@@ -29,10 +29,12 @@
 #include <climits>
 #include <ostream>
 #include <stdexcept>
+#include <string>
 
 #include "Node.hpp"
 #include "DataTable.hpp"
 #include "../util/MyVector.hpp"
+#include "../util/OutputBuffer.hpp"
 
 namespace tdzdd {
 
@@ -159,6 +161,61 @@ public:
         }
     }
 
+    /**
+     * Renumbers the columns of each row so that the children of adjacent
+     * parents are placed adjacently.
+     * Rows are scanned top-down in the new order and each child gets
+     * the next column of its row when it is visited first.
+     * Nodes that are not visited are kept at the end of the row.
+     * @param root reference to the root node ID storage.
+     */
+    void optimizeLayout(NodeId& root) {
+        int const n = numVars();
+        size_t const none = size_t(-1);
+        MyVector<MyVector<size_t> > newCol(n + 1);
+        MyVector<size_t> count(n + 1);
+
+        for (int i = 1; i <= n; ++i) {
+            newCol[i].resize((*this)[i].size());
+            for (size_t j = 0; j < newCol[i].size(); ++j) {
+                newCol[i][j] = none;
+            }
+            count[i] = 0;
+        }
+
+        for (int i = n; i >= 1; --i) {
+            MyVector<Node<ARITY> >& node = (*this)[i];
+            MyVector<size_t>& col = newCol[i];
+            size_t const m = node.size();
+
+            if (root.row() == i) {
+                if (col[root.col()] == none) col[root.col()] = count[i]++;
+                root = NodeId(i, col[root.col()], root.getAttr());
+            }
+
+            {
+                MyVector<Node<ARITY> > tmp(m);
+                for (size_t j = 0; j < m; ++j) {
+                    if (col[j] == none) col[j] = count[i]++;
+                    tmp[col[j]] = node[j];
+                }
+                node.swap(tmp);
+                col.clear();
+            }
+
+            for (size_t j = 0; j < m; ++j) {
+                for (int b = 0; b < ARITY; ++b) {
+                    NodeId& f = node[j].branch[b];
+                    int const ii = f.row();
+                    if (ii == 0) continue;
+                    size_t& c = newCol[ii][f.col()];
+                    if (c == none) c = count[ii]++;
+                    f = NodeId(ii, c, f.getAttr());
+                }
+            }
+        }
+    }
+
     /**
      * Gets a node.
      * @param f node ID.
@@ -329,17 +386,28 @@ public:
      * @param title title label.
      */
     void dumpDot(std::ostream& os, std::string title = "") const {
-        os << "digraph \"" << title << "\" {\n";
+        OutputBuffer out(os);
+        dumpDot(out, title);
+        out.flush();
+    }
+
+    /**
+     * Dumps the node table in Graphviz (dot) format.
+     * @param out output buffer.
+     * @param title title label.
+     */
+    void dumpDot(OutputBuffer& out, std::string title = "") const {
+        out << "digraph \"" << title << "\" {\n";
         for (int i = this->numRows() - 1; i >= 1; --i) {
-            os << "  " << i << " [shape=none];\n";
+            out << "  " << i << " [shape=none];\n";
         }
         for (int i = this->numRows() - 2; i >= 1; --i) {
-            os << "  " << (i + 1) << " -> " << i << " [style=invis];\n";
+            out << "  " << (i + 1) << " -> " << i << " [style=invis];\n";
         }
 
         if (!title.empty()) {
-            os << "  labelloc=\"t\";\n";
-            os << "  label=\"" << title << "\";\n";
+            out << "  labelloc=\"t\";\n";
+            out << "  label=\"" << title << "\";\n";
         }
 
         bool terminal1 = false;
@@ -349,52 +417,67 @@ public:
 
             for (size_t j = 0; j < m; ++j) {
                 NodeId f = NodeId(i, j);
-                os << "  \"" << f << "\";\n";
+                out << "  \"";
+                putNodeId(out, f);
+                out << "\";\n";
 
                 for (int b = 0; b < ARITY; ++b) {
                     NodeId ff = child(i, j, b);
                     bool aa = ff.getAttr();
                     if (ff == 0) continue;
 
+                    out << "  \"";
+                    putNodeId(out, f);
                     if (ff == 1) {
                         terminal1 = true;
-                        os << "  \"" << f << "\" -> \"$\"";
+                        out << "\" -> \"$\"";
                     }
                     else {
                         ff.setAttr(false);
-                        os << "  \"" << f << "\" -> \"" << ff << "\"";
+                        out << "\" -> \"";
+                        putNodeId(out, ff);
+                        out << '"';
                     }
 
-                    os << " [style=";
+                    out << " [style=";
                     if (b == 0) {
-                        os << "dashed";
+                        out << "dashed";
                     }
                     else {
-                        os << "solid";
+                        out << "solid";
                         if (ARITY > 2) {
-                            os << ",color="
+                            out << ",color="
                                     << ((b == 1) ? "blue" :
                                         (b == 2) ? "red" : "green");
                         }
                     }
-                    if (aa) os << ",arrowtail=dot";
-                    os << "];\n";
+                    if (aa) out << ",arrowtail=dot";
+                    out << "];\n";
                 }
             }
 
             if (terminal1) {
-                os << "  \"$\" [shape=square,label=\"⊤\"];\n";
+                out << "  \"$\" [shape=square,label=\"⊤\"];\n";
             }
 
-            os << "  {rank=same; " << i;
+            out << "  {rank=same; " << i;
             for (size_t j = 0; j < m; ++j) {
-                os << "; \"" << NodeId(i, j) << "\"";
+                out << "; \"";
+                putNodeId(out, NodeId(i, j));
+                out << '"';
             }
-            os << "}\n";
+            out << "}\n";
         }
 
-        os << "}\n";
-        os.flush();
+        out << "}\n";
+    }
+
+private:
+    /* Same format as operator<<(std::ostream&, NodeId const&). */
+    static void putNodeId(OutputBuffer& out, NodeId f) {
+        out << f.row() << ':';
+        out.putUnsigned(f.col());
+        if (f.getAttr()) out << '+';
     }
 };
 
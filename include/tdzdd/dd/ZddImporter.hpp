@@ -0,0 +1,506 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Node.hpp"
+#include "NodeTable.hpp"
+#include "../util/MyVector.hpp"
+
+namespace tdzdd {
+
+/**
+ * Parser of ZDD text formats that builds a node table directly.
+ * The input is split into line-aligned chunks, which are scanned
+ * in parallel when MP algorithms are enabled.
+ *
+ * Node references are encoded as 0 (0-terminal), 1 (1-terminal)
+ * or 2 + 2 * k + c, where k is the record index and c is the
+ * complement flag of Sapporo's odd IDs.
+ */
+template<int ARITY>
+class ZddImporter {
+public:
+    enum Format {
+        SAPPORO,    ///< Output of DdStructure::dumpSapporo or SAPPOROBDD.
+        GRAPHILLION ///< Output of Graphillion's setset::dump.
+    };
+
+private:
+    static size_t const CHUNK_SIZE = size_t(1) << 24;
+    static size_t const NONE = size_t(-1);
+
+    struct Record {
+        uint64_t id;
+        uint64_t child[2];
+        int64_t level;
+        size_t col;
+    };
+
+    struct Chunk {
+        char const* begin;
+        char const* end;
+        std::vector<Record> records;
+        uint64_t root;
+        bool hasRoot;
+        int64_t numVars;
+        int64_t numOutputs;
+        bool finished;
+        std::string error;
+
+        Chunk() :
+                begin(0), end(0), root(0), hasRoot(false), numVars(-1),
+                numOutputs(-1), finished(false) {
+        }
+    };
+
+    Format const format;
+    bool const useMP;
+
+    static char const* skipBlank(char const* p, char const* e) {
+        while (p < e && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            ++p;
+        }
+        return p;
+    }
+
+    static char const* skipLine(char const* p, char const* e) {
+        if (p >= e) return e;
+        char const* q = static_cast<char const*>(std::memchr(p, '\n', e - p));
+        return q ? q + 1 : e;
+    }
+
+    static char const* readNumber(char const* p, char const* e, uint64_t& v) {
+        v = 0;
+        for (; p < e; ++p) {
+            unsigned d = static_cast<unsigned char>(*p) - '0';
+            if (d > 9) break;
+            v = v * 10 + d;
+        }
+        return p;
+    }
+
+    /*
+     * Reads a token as a reference: 0 for F/B, 1 for T
+     * and 2 + the number for a node.
+     */
+    static char const* readToken(char const* p, char const* e, uint64_t& v) {
+        unsigned d = static_cast<unsigned char>(*p) - '0';
+        if (d <= 9) {
+            p = readNumber(p, e, v);
+            v += 2;
+        }
+        else {
+            switch (*p++) {
+            case 'T':
+            case 't':
+                v = 1;
+                break;
+            case 'F':
+            case 'f':
+            case 'B':
+            case 'b':
+                v = 0;
+                break;
+            default:
+                return 0;
+            }
+        }
+        if (p < e && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+            return 0;
+        }
+        return p;
+    }
+
+    static std::string lineAt(char const* p, char const* e) {
+        char const* q = skipLine(p, e);
+        while (q > p && (q[-1] == '\n' || q[-1] == '\r')) {
+            --q;
+        }
+        return std::string(p, q);
+    }
+
+    void scan(Chunk& chunk) const {
+        char const* p = chunk.begin;
+        char const* const e = chunk.end;
+
+        while (p < e) {
+            char const* const line = p = skipBlank(p, e);
+            if (p == e) break;
+
+            if (*p == '\n') {
+                ++p;
+                continue;
+            }
+
+            if (*p == '_') {
+                uint64_t v;
+                char c = (p + 1 < e) ? p[1] : 0;
+                char const* q = readNumber(skipBlank(p + 2, e), e, v);
+                if (c == 'i') chunk.numVars = v;
+                if (c == 'o') chunk.numOutputs = v;
+                p = skipLine(q, e);
+                continue;
+            }
+
+            if (*p == '.') {
+                chunk.finished = true;
+                break;
+            }
+
+            uint64_t t[4];
+            int k = 0;
+            while (p < e && *p != '\n' && k < 4) {
+                p = readToken(p, e, t[k++]);
+                if (p == 0) break;
+                p = skipBlank(p, e);
+            }
+
+            if (p == 0 || (p < e && *p != '\n') || (k != 1 && k != 4)
+                    || (k == 4 && (t[0] < 2 || t[1] < 2))) {
+                chunk.error = "Illegal line: \"" + lineAt(line, e) + "\"";
+                break;
+            }
+
+            if (k == 1) {
+                chunk.root = t[0];
+                chunk.hasRoot = true;
+            }
+            else {
+                Record r;
+                r.id = t[0] - 2;
+                r.level = t[1] - 2;
+                r.child[0] = t[2];
+                r.child[1] = t[3];
+                r.col = 0;
+                chunk.records.push_back(r);
+            }
+
+            p = skipLine(p, e);
+        }
+    }
+
+    /*
+     * Splits a node number into the lookup key and the complement flag.
+     */
+    uint64_t keyOf(uint64_t id) const {
+        return (format == SAPPORO) ? id >> 1 : id;
+    }
+
+    class KeyMap {
+        MyVector<size_t> dense;
+        std::vector<std::pair<uint64_t,size_t> > sparse;
+
+    public:
+        KeyMap(ZddImporter const& zi, MyVector<Record> const& records) {
+            size_t const m = records.size();
+            uint64_t maxKey = 0;
+            for (size_t r = 0; r < m; ++r) {
+                maxKey = std::max(maxKey, zi.keyOf(records[r].id));
+            }
+
+            if (maxKey < 4 * m + 1024) {
+                dense.resize(maxKey + 1);
+                std::fill(dense.begin(), dense.end(), NONE);
+                for (size_t r = 0; r < m; ++r) {
+                    size_t& x = dense[zi.keyOf(records[r].id)];
+                    if (x != NONE) {
+                        throw std::runtime_error("Duplicate node ID");
+                    }
+                    x = r;
+                }
+            }
+            else {
+                sparse.reserve(m);
+                for (size_t r = 0; r < m; ++r) {
+                    sparse.push_back(std::make_pair(zi.keyOf(records[r].id),
+                            r));
+                }
+                std::sort(sparse.begin(), sparse.end());
+                for (size_t r = 1; r < m; ++r) {
+                    if (sparse[r - 1].first == sparse[r].first) {
+                        throw std::runtime_error("Duplicate node ID");
+                    }
+                }
+            }
+        }
+
+        size_t find(uint64_t key) const {
+            if (sparse.empty()) {
+                return (key < dense.size()) ? dense[key] : NONE;
+            }
+            std::vector<std::pair<uint64_t,size_t> >::const_iterator t =
+                    std::lower_bound(sparse.begin(), sparse.end(),
+                            std::make_pair(key, size_t(0)));
+            return (t != sparse.end() && t->first == key) ? t->second : NONE;
+        }
+    };
+
+    /*
+     * Converts a reference in the file into the internal encoding.
+     */
+    uint64_t resolve(KeyMap const& map, uint64_t ref) const {
+        if (ref < 2) return ref;
+        uint64_t id = ref - 2;
+        size_t r = map.find(keyOf(id));
+        if (r == NONE) throw std::runtime_error("Undefined node ID");
+        uint64_t c = (format == SAPPORO) ? (id & 1) : 0;
+        return 2 + 2 * uint64_t(r) + c;
+    }
+
+    static bool isComplemented(uint64_t ref) {
+        return ref >= 2 && (ref & 1);
+    }
+
+    static NodeId nodeOf(MyVector<Record> const& records,
+            MyVector<size_t> const& compCol, uint64_t ref) {
+        if (ref < 2) return NodeId(ref);
+        size_t r = (ref - 2) >> 1;
+        int i = records[r].level;
+        return NodeId(i, (ref & 1) ? compCol[r] : records[r].col);
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param format the input format.
+     * @param useMP scan the input in parallel.
+     */
+    ZddImporter(Format format, bool useMP = false) :
+            format(format), useMP(useMP) {
+    }
+
+    /**
+     * Parses the text and builds the node table.
+     * Nodes appear in each row in the order of the input; a complemented
+     * reference of SAPPOROBDD adds a copy of the node with the empty
+     * set toggled.
+     * @param output the node table.
+     * @param begin the first byte of the text.
+     * @param end the end of the text.
+     * @return the root node.
+     */
+    NodeId read(NodeTableHandler<ARITY>& output, char const* begin,
+            char const* end) const {
+        /* Line-aligned chunks. */
+        std::vector<Chunk> chunks;
+        int parallelism = 1;
+#ifdef _OPENMP
+        if (useMP) parallelism = omp_get_max_threads() * 4;
+#endif
+        size_t const len = end - begin;
+        size_t const step = std::max(CHUNK_SIZE, len / parallelism + 1);
+        for (char const* p = begin; p < end;) {
+            Chunk c;
+            c.begin = p;
+            c.end = (size_t(end - p) <= step) ? end : skipLine(p + step, end);
+            chunks.push_back(c);
+            p = c.end;
+        }
+        intmax_t const numChunks = chunks.size();
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (useMP)
+#endif
+        for (intmax_t k = 0; k < numChunks; ++k) {
+            scan(chunks[k]);
+        }
+
+        /* Merge the chunks in the order of the input. */
+        uint64_t rootRef = 0;
+        bool hasRoot = false;
+        int64_t numVars = 0;
+        size_t m = 0;
+        intmax_t used = 0;
+        while (used < numChunks) {
+            Chunk const& c = chunks[used++];
+            if (!c.error.empty()) throw std::runtime_error(c.error);
+            if (c.numOutputs > 1) {
+                throw std::runtime_error("Multiple roots are not supported");
+            }
+            if (c.numVars >= 0) numVars = c.numVars;
+            if (c.hasRoot) rootRef = c.root, hasRoot = true;
+            m += c.records.size();
+            if (c.finished) break;
+        }
+
+        MyVector<Record> records(m);
+        MyVector<size_t> offset(used + 1);
+        offset[0] = 0;
+        for (intmax_t k = 0; k < used; ++k) {
+            offset[k + 1] = offset[k] + chunks[k].records.size();
+        }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) if (useMP)
+#endif
+        for (intmax_t k = 0; k < used; ++k) {
+            std::copy(chunks[k].records.begin(), chunks[k].records.end(),
+                    records.begin() + offset[k]);
+            std::vector<Record>().swap(chunks[k].records);
+        }
+
+        /* Levels. */
+        int64_t n = 0;
+        if (format == GRAPHILLION) {
+            /* The root has the smallest index. */
+            int64_t minIndex = std::numeric_limits<int64_t>::max();
+            int64_t maxIndex = 0;
+            for (size_t r = 0; r < m; ++r) {
+                if (records[r].level < minIndex) {
+                    minIndex = records[r].level;
+                    rootRef = records[r].id + 2;
+                    hasRoot = true;
+                }
+                maxIndex = std::max(maxIndex, records[r].level);
+            }
+            for (size_t r = 0; r < m; ++r) {
+                records[r].level = maxIndex - records[r].level + 1;
+            }
+            if (m > 0) n = maxIndex - minIndex + 1;
+        }
+        else {
+            n = numVars;
+            for (size_t r = 0; r < m; ++r) {
+                if (records[r].level < 1) {
+                    throw std::runtime_error("Illegal level");
+                }
+                n = std::max(n, records[r].level);
+            }
+            if (m > 0 && !hasRoot) throw std::runtime_error("No root");
+        }
+        if (n > int64_t(NODE_ROW_MAX)) {
+            throw std::runtime_error("Too many levels");
+        }
+
+        /* References. */
+        KeyMap map(*this, records);
+        bool complemented = false;
+        for (size_t r = 0; r < m; ++r) {
+            Record& rec = records[r];
+            for (int b = 0; b < 2; ++b) {
+                uint64_t ref = resolve(map, rec.child[b]);
+                if (ref >= 2 && records[(ref - 2) >> 1].level >= rec.level) {
+                    throw std::runtime_error(
+                            "Child node is not at a lower level");
+                }
+                if (isComplemented(ref)) complemented = true;
+                rec.child[b] = ref;
+            }
+        }
+        uint64_t root = resolve(map, rootRef);
+        if (isComplemented(root)) complemented = true;
+
+        /* Columns in the order of the input. */
+        MyVector<size_t> rowSize(n + 1);
+        std::fill(rowSize.begin(), rowSize.end(), size_t(0));
+        for (size_t r = 0; r < m; ++r) {
+            records[r].col = rowSize[records[r].level]++;
+        }
+
+        /* Copies of complemented nodes are placed after the originals.
+         * A copy needs the complement of its 0-child, so the demands are
+         * propagated from the top row downward. */
+        MyVector<size_t> compCol;
+        if (complemented) {
+            compCol.resize(m);
+            std::fill(compCol.begin(), compCol.end(), NONE);
+            MyVector<size_t> rowStart(n + 2);
+            rowStart[0] = 0;
+            for (int64_t i = 0; i <= n; ++i) {
+                rowStart[i + 1] = rowStart[i] + rowSize[i];
+            }
+            MyVector<size_t> byRow(m);
+            for (size_t r = 0; r < m; ++r) {
+                Record const& rec = records[r];
+                byRow[rowStart[rec.level] + rec.col] = r;
+            }
+
+            MyVector<char> need(m);
+            std::fill(need.begin(), need.end(), 0);
+            if (isComplemented(root)) need[(root - 2) >> 1] = 1;
+
+            for (int64_t i = n; i >= 1; --i) {
+                for (size_t k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+                    size_t r = byRow[k];
+                    Record const& rec = records[r];
+                    for (int b = 0; b < 2; ++b) {
+                        uint64_t ref = rec.child[b];
+                        if (isComplemented(ref)) need[(ref - 2) >> 1] = 1;
+                    }
+                    if (need[r]) {
+                        uint64_t ref = rec.child[0] ^ 1;
+                        if (isComplemented(ref)) need[(ref - 2) >> 1] = 1;
+                        compCol[r] = rowSize[i]++;
+                    }
+                }
+            }
+        }
+
+        /* The node table. */
+        NodeTableEntity<ARITY>& table = output.init(n + 1);
+        for (int i = 1; i <= n; ++i) {
+            table.initRow(i, rowSize[i]);
+        }
+
+        intmax_t const mm = m;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (useMP)
+#endif
+        for (intmax_t r = 0; r < mm; ++r) {
+            Record const& rec = records[r];
+            NodeId f0 = nodeOf(records, compCol, rec.child[0]);
+            NodeId f1 = nodeOf(records, compCol, rec.child[1]);
+            table[rec.level][rec.col] = Node<ARITY>(f0, f1);
+            if (complemented && compCol[r] != NONE) {
+                NodeId g0 = nodeOf(records, compCol, rec.child[0] ^ 1);
+                table[rec.level][compCol[r]] = Node<ARITY>(g0, f1);
+            }
+        }
+
+        return nodeOf(records, compCol, root);
+    }
+};
+
+template<int ARITY>
+size_t const ZddImporter<ARITY>::CHUNK_SIZE;
+
+template<int ARITY>
+size_t const ZddImporter<ARITY>::NONE;
+
+} // namespace tdzdd
@@ -0,0 +1,76 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "../DdEval.hpp"
+
+namespace tdzdd {
+
+/**
+ * ZDD evaluator that finds the maximum total weight of the items
+ * in a set of the family.
+ * The items are the levels of the ZDD, and a set weighs the sum of
+ * the weights of its items.
+ * The value of the empty family is noSolution().
+ * @tparam T data type of weights, which can be integral or real.
+ */
+template<typename T>
+class ZddMaxWeight: public DdEval<ZddMaxWeight<T>,T> {
+    std::vector<T> weights;
+
+public:
+    /**
+     * Constructor.
+     * @param weights the weight of the item at each level.
+     */
+    ZddMaxWeight(std::vector<T> const& weights) :
+            weights(weights) {
+    }
+
+    /**
+     * Gets the value of the empty family.
+     * @return the lowest value of T.
+     */
+    static T noSolution() {
+        return -std::numeric_limits<T>::max();
+    }
+
+    void evalTerminal(T& v, bool one) const {
+        v = one ? T(0) : noSolution();
+    }
+
+    void evalNode(T& v, int i, DdValues<T,2> const& values) const {
+        v = values.get(0);
+        if (values.get(1) == noSolution()) return;
+        T w = values.get(1);
+        if (size_t(i) < weights.size()) w += weights[i];
+        if (v < w) v = w;
+    }
+};
+
+} // namespace tdzdd
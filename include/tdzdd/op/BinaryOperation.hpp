@@ -26,6 +26,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
 
 #include "../DdSpec.hpp"
 
@@ -103,6 +104,25 @@ public:
                 | spec2.merge_states(state2(p1), state2(p2));
     }
 
+    double score_state(void const* p, int level) const {
+        double s = 0;
+        if (level1(p) > 0) s += spec1.score_state(state1(p), level1(p));
+        if (level2(p) > 0) s += spec2.score_state(state2(p), level2(p));
+        return s;
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        if (level1(p1) != level1(p2) || level2(p1) != level2(p2))
+            throw std::runtime_error(
+                    "cannot relax operand states at different levels");
+        int code = 0;
+        if (level1(p1) > 0)
+            code |= spec1.relax_states(state1(p1), state1(p2), level1(p1));
+        if (level2(p1) > 0)
+            code |= spec2.relax_states(state2(p1), state2(p2), level2(p1));
+        return code;
+    }
+
     void destruct(void* p) {
         spec1.destruct(state1(p));
         spec2.destruct(state2(p));
@@ -393,6 +413,16 @@ public:
                 | spec2.merge_states(state2(p1), state2(p2));
     }
 
+    double score_state(void const* p, int level) const {
+        return spec1.score_state(state1(p), level)
+                + spec2.score_state(state2(p), level);
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        return spec1.relax_states(state1(p1), state1(p2), level)
+                | spec2.relax_states(state2(p1), state2(p2), level);
+    }
+
     void destruct(void* p) {
         spec1.destruct(state1(p));
         spec2.destruct(state2(p));
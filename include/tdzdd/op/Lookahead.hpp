@@ -32,6 +32,158 @@
 
 namespace tdzdd {
 
+/**
+ * Cache of lookahead results.
+ * It maps a state at a level to the state and the level reached after
+ * skipping redundant nodes.
+ * Each level has a direct-mapped table of a fixed number of slots;
+ * a new entry evicts the old one stored in the same slot.
+ * The table of a level is discarded when the level is destructed.
+ * @tparam S the spec type.
+ */
+template<typename S>
+class LookaheadMemo {
+    typedef S Spec;
+    typedef size_t Word;
+
+    size_t const capacity;
+    int const stateWords;
+    int const slotWords;
+    std::vector<std::vector<Word> > table;
+
+    /* Slot
+     * ┌────────┬──────────┬──────────┐
+     * │ target │ state... │ target...│
+     * │ level  │ (key)    │ (value)  │
+     * └────────┴──────────┴──────────┘
+     * The target level is stored with an offset of 2 so that 0 means empty.
+     * The target state is omitted when it is identical to the key.
+     */
+    static Word& header(Word* slot) {
+        return slot[0];
+    }
+
+    void* key(Word* slot) const {
+        return slot + 1;
+    }
+
+    void* value(Word* slot) const {
+        return slot + 1 + stateWords;
+    }
+
+    static int wordSize(int size) {
+        return (size + sizeof(Word) - 1) / sizeof(Word);
+    }
+
+    void evict(Spec& spec, Word* slot, int level) {
+        if (header(slot) == 0) return;
+        int target = int(header(slot)) - 2;
+        spec.destruct(key(slot));
+        if (target != level) spec.destruct(value(slot));
+        header(slot) = 0;
+    }
+
+    Word* slotOf(Spec const& spec, void const* p, int level) {
+        if (size_t(level) >= table.size()) table.resize(level + 1);
+        std::vector<Word>& t = table[level];
+        if (t.empty()) t.resize(capacity * slotWords);
+        size_t k = spec.hash_code(p, level) % capacity;
+        return &t[k * slotWords];
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param capacity the number of slots for each level; 0 to disable.
+     * @param datasize the state size in bytes.
+     */
+    LookaheadMemo(size_t capacity, int datasize)
+            : capacity(capacity), stateWords(wordSize(datasize)),
+              slotWords(1 + 2 * stateWords) {
+    }
+
+    /**
+     * Copy constructor.
+     * The cached entries are not copied.
+     */
+    LookaheadMemo(LookaheadMemo const& o)
+            : capacity(o.capacity), stateWords(o.stateWords),
+              slotWords(o.slotWords) {
+    }
+
+    /**
+     * Checks if the cache is enabled.
+     * @return true if enabled.
+     */
+    bool enabled() const {
+        return capacity > 0;
+    }
+
+    /**
+     * Looks up the cache.
+     * On a hit, the state is replaced with the cached target.
+     * @param spec the spec.
+     * @param p the state.
+     * @param level the level of the state, which is updated on a hit.
+     * @return true on a hit.
+     */
+    bool lookup(Spec& spec, void* p, int& level) {
+        Word* slot = slotOf(spec, p, level);
+        if (header(slot) == 0) return false;
+        if (!spec.equal_to(key(slot), p, level)) return false;
+
+        int target = int(header(slot)) - 2;
+        if (target != level) {
+            spec.destruct(p);
+            spec.get_copy(p, value(slot));
+            level = target;
+        }
+        return true;
+    }
+
+    /**
+     * Stores a lookahead result.
+     * @param spec the spec.
+     * @param p the original state.
+     * @param level the level of the original state.
+     * @param q the target state.
+     * @param target the target level.
+     */
+    void store(Spec& spec, void const* p, int level, void const* q,
+               int target) {
+        Word* slot = slotOf(spec, p, level);
+        evict(spec, slot, level);
+        spec.get_copy(key(slot), p);
+        if (target != level) spec.get_copy(value(slot), q);
+        header(slot) = target + 2;
+    }
+
+    /**
+     * Discards the table of a level.
+     * @param spec the spec.
+     * @param level the level.
+     */
+    void clear(Spec& spec, int level) {
+        if (size_t(level) >= table.size()) return;
+        std::vector<Word>& t = table[level];
+        for (size_t k = 0; k < t.size(); k += slotWords) {
+            evict(spec, &t[k], level);
+        }
+        std::vector<Word>().swap(t);
+    }
+
+    /**
+     * Discards all tables.
+     * @param spec the spec.
+     */
+    void clear(Spec& spec) {
+        for (size_t i = 0; i < table.size(); ++i) {
+            clear(spec, i);
+        }
+        table.clear();
+    }
+};
+
 template<typename S>
 class BddLookahead: public DdSpecBase<BddLookahead<S>,S::ARITY> {
     typedef S Spec;
@@ -39,8 +191,22 @@ class BddLookahead: public DdSpecBase<BddLookahead<S>,S::ARITY> {
     Spec spec;
     std::vector<char> work0;
     std::vector<char> work1;
+    std::vector<char> work2;
+    LookaheadMemo<Spec> memo;
 
     int lookahead(void* p, int level) {
+        if (!memo.enabled() || level < 1) return lookahead_(p, level);
+        int target = level;
+        if (memo.lookup(spec, p, target)) return target;
+
+        spec.get_copy(work2.data(), p);
+        target = lookahead_(p, level);
+        memo.store(spec, work2.data(), level, p, target);
+        spec.destruct(work2.data());
+        return target;
+    }
+
+    int lookahead_(void* p, int level) {
         while (level >= 1) {
             spec.get_copy(work0.data(), p);
             int level0 = spec.get_child(work0.data(), level, 0);
@@ -69,8 +235,20 @@ class BddLookahead: public DdSpecBase<BddLookahead<S>,S::ARITY> {
     }
 
 public:
-    BddLookahead(S const& s)
-            : spec(s), work0(spec.datasize()), work1(spec.datasize()) {
+    /**
+     * Constructor.
+     * @param s the spec.
+     * @param memoSize the number of cached lookahead results for each
+     *        level; 0 to disable the cache.
+     *        The cache should be used only if @p s is deterministic.
+     */
+    BddLookahead(S const& s, size_t memoSize = 0)
+            : spec(s), work0(spec.datasize()), work1(spec.datasize()),
+              work2(spec.datasize()), memo(memoSize, spec.datasize()) {
+    }
+
+    ~BddLookahead() {
+        memo.clear(spec);
     }
 
     int datasize() const {
@@ -93,11 +271,20 @@ public:
         return spec.merge_states(p1, p2);
     }
 
+    double score_state(void const* p, int level) const {
+        return spec.score_state(p, level);
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        return spec.relax_states(p1, p2, level);
+    }
+
     void destruct(void* p) {
         spec.destruct(p);
     }
 
     void destructLevel(int level) {
+        memo.clear(spec, level);
         spec.destructLevel(level);
     }
 
@@ -124,8 +311,22 @@ class ZddLookahead: public DdSpecBase<ZddLookahead<S>,S::ARITY> {
 
     Spec spec;
     std::vector<char> work;
+    std::vector<char> work2;
+    LookaheadMemo<Spec> memo;
 
     int lookahead(void* p, int level) {
+        if (!memo.enabled() || level < 1) return lookahead_(p, level);
+        int target = level;
+        if (memo.lookup(spec, p, target)) return target;
+
+        spec.get_copy(work2.data(), p);
+        target = lookahead_(p, level);
+        memo.store(spec, work2.data(), level, p, target);
+        spec.destruct(work2.data());
+        return target;
+    }
+
+    int lookahead_(void* p, int level) {
         void* const q = work.data();
         while (level >= 1) {
             for (int b = 1; b < Spec::ARITY; ++b) {
@@ -143,8 +344,20 @@ class ZddLookahead: public DdSpecBase<ZddLookahead<S>,S::ARITY> {
     }
 
 public:
-    ZddLookahead(S const& s)
-            : spec(s), work(spec.datasize()) {
+    /**
+     * Constructor.
+     * @param s the spec.
+     * @param memoSize the number of cached lookahead results for each
+     *        level; 0 to disable the cache.
+     *        The cache should be used only if @p s is deterministic.
+     */
+    ZddLookahead(S const& s, size_t memoSize = 0)
+            : spec(s), work(spec.datasize()), work2(spec.datasize()),
+              memo(memoSize, spec.datasize()) {
+    }
+
+    ~ZddLookahead() {
+        memo.clear(spec);
     }
 
     int datasize() const {
@@ -167,11 +380,20 @@ public:
         return spec.merge_states(p1, p2);
     }
 
+    double score_state(void const* p, int level) const {
+        return spec.score_state(p, level);
+    }
+
+    int relax_states(void* p1, void* p2, int level) {
+        return spec.relax_states(p1, p2, level);
+    }
+
     void destruct(void* p) {
         spec.destruct(p);
     }
 
     void destructLevel(int level) {
+        memo.clear(spec, level);
         spec.destructLevel(level);
     }
 
@@ -26,6 +26,7 @@
 
 #include <cassert>
 #include <iostream>
+#include <stdexcept>
 
 #include "../DdSpec.hpp"
 
@@ -108,6 +109,18 @@ public:
         return spec.merge_states(state(p1), state(p2));
     }
 
+    double score_state(void const* p, int i) const {
+        return (level(p) > 0) ? spec.score_state(state(p), level(p)) : 0;
+    }
+
+    int relax_states(void* p1, void* p2, int i) {
+        if (level(p1) != level(p2))
+            throw std::runtime_error(
+                    "cannot relax operand states at different levels");
+        if (level(p1) <= 0) return 0;
+        return spec.relax_states(state(p1), state(p2), level(p1));
+    }
+
     size_t hash_code(void const* p, int i) const {
         size_t h = size_t(level(p)) * 314159257;
         if (level(p) > 0) h += spec.hash_code(state(p), level(p)) * 271828171;
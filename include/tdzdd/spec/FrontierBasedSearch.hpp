@@ -24,6 +24,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <stdint.h>
@@ -71,6 +72,8 @@ private:
     Offset hoc; ///< offset to head or color.
     Offset nxt; ///< offset to next connected vertex.
 
+    friend class FrontierBasedSearch;
+
     /*
      *  ┌────────────────────────┌─────────────────────┐
      *  │   ┌────┐────────┐      │   ┌────┐────────┐   │
@@ -263,10 +266,24 @@ public:
     }
 };
 
+/**
+ * Frontier-based search for subgraphs such as paths, cycles and forests.
+ * In the compact mode, the mates of the frontier vertices are kept in
+ * a canonical bit-packed form: each vertex has a code of a few bits,
+ * which is 0 for an untouched uncolored vertex, 1 for an isolated vertex
+ * that is its own color tail or has left, or 2 plus the rank of its
+ * component, where components are numbered in order of their first
+ * occurrence in the frontier.
+ * When the graph has colors, a flag bit per rank and a 16-bit color offset
+ * per colored component follow the codes.
+ * It shrinks a state severalfold on wide frontiers at the cost of
+ * decoding and encoding it in every transition.
+ */
 class FrontierBasedSearch: public tdzdd::HybridDdSpec<FrontierBasedSearch,
-        FrontierBasedSearchCount,FrontierBasedSearchMate,2> {
+        FrontierBasedSearchCount,uint64_t,2> {
     typedef FrontierBasedSearchCount Count;
     typedef FrontierBasedSearchMate Mate;
+    typedef uint64_t Word;
 
     Graph const& graph;
     int const m;
@@ -276,6 +293,148 @@ class FrontierBasedSearch: public tdzdd::HybridDdSpec<FrontierBasedSearch,
     int numUEC;
     bool const noLoop;
     bool const lookahead;
+    bool const compact;
+
+    int codeBits;   ///< bits of a vertex code.
+    int colorSlots; ///< maximum number of colored components in a state.
+    int flagBase;   ///< bit offset of the color flags.
+    int colorBase;  ///< bit offset of the color offsets.
+
+    mutable std::vector<Mate> work; ///< decoded mates.
+    mutable std::vector<int> vertexCode;
+    mutable std::vector<int> rankHead;
+    mutable std::vector<int> rankTail;
+
+    static Word getBits(Word const* a, int pos, int width) {
+        int const i = pos >> 6;
+        int const j = pos & 63;
+        Word x = a[i] >> j;
+        if (j + width > 64) x |= a[i + 1] << (64 - j);
+        return x & ((Word(1) << width) - 1);
+    }
+
+    static void putBits(Word* a, int pos, int width, Word x) {
+        int const i = pos >> 6;
+        int const j = pos & 63;
+        a[i] |= x << j;
+        if (j + width > 64) a[i + 1] |= x >> (64 - j);
+    }
+
+    static int select(bool cond, int x, int y) {
+        int const mask = -int(cond);
+        return (x & mask) | (y & ~mask);
+    }
+
+    /*
+     * The loops of encode() and decode() avoid branches by select()
+     * because the kinds of codes are hardly predictable.
+     */
+    void encode(Mate const* mate, Word* a) const {
+        int const size = mateSize;
+        int const width = codeBits;
+        bool const colored = colorSlots > 0;
+        int* const vcode = &vertexCode[0];
+        Word* const az = a + getArraySize();
+        Word* p = a;
+        Word acc = 0;
+        int fill = 0;
+        int ranks = 0;
+        int colors = 0;
+
+        for (int i = 0; i < size; ++i) {
+            int const hoc = mate[i].hoc;
+            int const nxt = mate[i].nxt;
+            bool const head = hoc >= 0;
+            bool const isolated = (nxt == 0)
+                    & ((hoc == Mate::UNCOLORED) | (hoc == 0));
+            bool const ranked = head & !isolated;
+            int const c = vcode[i + select(head, 0, hoc)];
+            int const code = select(head, select(isolated, hoc == 0, ranks + 2),
+                    c);
+
+            if (colored && ranked
+                    && hoc != Mate::UNCOLORED_EDGE_COMPONENT) {
+                assert(hoc < Mate::UNCOLORED);
+                assert(colors < colorSlots);
+                rankHead[colors] = ranks;
+                rankTail[colors] = hoc;
+                ++colors;
+            }
+            assert(colored || !ranked
+                    || hoc == Mate::UNCOLORED_EDGE_COMPONENT);
+
+            ranks += ranked;
+            vcode[i] = code;
+            acc |= Word(code) << fill;
+            fill += width;
+            if (fill >= 64) {
+                *p++ = acc;
+                fill -= 64;
+                acc = (fill > 0) ? Word(code) >> (width - fill) : 0;
+            }
+        }
+
+        if (fill > 0) *p++ = acc;
+        while (p != az) {
+            *p++ = 0;
+        }
+
+        for (int k = 0; k < colors; ++k) {
+            putBits(a, flagBase + rankHead[k], 1, 1);
+            putBits(a, colorBase + 16 * k, 16, rankTail[k]);
+        }
+    }
+
+    void decode(Word const* a, Mate* mate) const {
+        static int const hocOfCode[] = { Mate::UNCOLORED, 0,
+                                         Mate::UNCOLORED_EDGE_COMPONENT };
+        int const size = mateSize;
+        int const width = codeBits;
+        bool const colored = colorSlots > 0;
+        Word const mask = (Word(1) << width) - 1;
+        int* const head = &rankHead[0]; // indexed by codes
+        int* const tail = &rankTail[0]; // indexed by codes
+        Word const* p = a;
+        Word acc = *p++;
+        int avail = 64;
+        int next = 2;
+        int colors = 0;
+
+        for (int i = 0; i < size; ++i) {
+            int code;
+
+            if (avail >= width) {
+                code = acc & mask;
+                acc >>= width;
+                avail -= width;
+            }
+            else {
+                Word x = *p++;
+                code = (acc | x << avail) & mask;
+                acc = x >> (width - avail);
+                avail += 64 - width;
+            }
+
+            // A vertex of a new component or an isolated vertex links to itself.
+            bool const first = (code < 2) | (code == next);
+            int const h = select(first, i, head[code]);
+            int const t = select(first, i, tail[code]);
+            int hoc = hocOfCode[select(code < 2, code, 2)];
+
+            if (colored && code == next
+                    && getBits(a, flagBase + code - 2, 1)) {
+                hoc = getBits(a, colorBase + 16 * colors, 16);
+                ++colors;
+            }
+
+            head[code] = h;
+            tail[code] = i;
+            mate[i].nxt = 0;
+            mate[t].nxt = i - t;
+            mate[i].hoc = select(first, hoc, h - i);
+            next += (code == next);
+        }
+    }
 
     int takable(Count& c, Mate const* mate, Graph::EdgeInfo const& e) const {
         Mate const& w1 = mate[e.v1 - e.v0];
@@ -413,38 +572,7 @@ class FrontierBasedSearch: public tdzdd::HybridDdSpec<FrontierBasedSearch,
         }
     }
 
-public:
-    FrontierBasedSearch(Graph const& graph, int numUEC = -1,
-            bool noLoop = false, bool lookahead = true)
-            : graph(graph), m(graph.vertexSize()), n(graph.edgeSize()),
-              mateSize(graph.maxFrontierSize()), initialMate(1 + m + mateSize),
-              numUEC(numUEC), noLoop(noLoop), lookahead(lookahead) {
-        this->setArraySize(mateSize);
-
-        std::vector<int> rootOfColor(graph.numColor() + 1);
-        for (int v = 1; v <= m; ++v) {
-            rootOfColor[graph.colorNumber(v)] = v;
-        }
-        for (int v = 1; v <= m; ++v) {
-            int k = graph.colorNumber(v);
-            int hoc = (k > 0) ? rootOfColor[k] - v : Mate::UNCOLORED;
-            initialMate[v] = Mate(hoc);
-        }
-    }
-
-    int getRoot(Count& count, Mate* mate) const {
-        int const v0 = graph.edgeInfo(0).v0;
-
-        count = Count(numUEC);
-
-        for (int i = 0; i < mateSize; ++i) {
-            mate[i] = initialMate[v0 + i];
-        }
-
-        return n;
-    }
-
-    int getChild(Count& count, Mate* mate, int level, int take) const {
+    int advance(Count& count, Mate* mate, int level, int take) const {
         assert(1 <= level && level <= n);
         int i = n - level;
         Graph::EdgeInfo const* e = &graph.edgeInfo(i);
@@ -478,9 +606,91 @@ public:
         return n - i;
     }
 
+public:
+    /**
+     * Constructor.
+     * @param graph the graph.
+     * @param numUEC the number of uncolored edge components or -1.
+     * @param noLoop true to exclude cycles.
+     * @param lookahead true to skip edges that cannot be taken.
+     * @param compact true to keep states in the compact form.
+     */
+    FrontierBasedSearch(Graph const& graph, int numUEC = -1,
+            bool noLoop = false, bool lookahead = true, bool compact = false)
+            : graph(graph), m(graph.vertexSize()), n(graph.edgeSize()),
+              mateSize(graph.maxFrontierSize()), initialMate(1 + m + mateSize),
+              numUEC(numUEC), noLoop(noLoop), lookahead(lookahead),
+              compact(compact), work(mateSize), vertexCode(mateSize), rankHead(mateSize + 2),
+              rankTail(mateSize + 2) {
+        std::vector<int> rootOfColor(graph.numColor() + 1);
+        int coloredVertices = 0;
+        for (int v = 1; v <= m; ++v) {
+            rootOfColor[graph.colorNumber(v)] = v;
+            if (graph.colorNumber(v) > 0) ++coloredVertices;
+        }
+        for (int v = 1; v <= m; ++v) {
+            int k = graph.colorNumber(v);
+            int hoc = (k > 0) ? rootOfColor[k] - v : Mate::UNCOLORED;
+            initialMate[v] = Mate(hoc);
+        }
+
+        // A colored component descends from a distinct colored vertex.
+        codeBits = 1;
+        while ((mateSize + 1) >> codeBits) {
+            ++codeBits;
+        }
+        colorSlots = std::min(mateSize, coloredVertices);
+        flagBase = codeBits * mateSize;
+        colorBase = flagBase + (colorSlots > 0 ? mateSize : 0);
+        this->setArraySize(compact ? (colorBase + 16 * colorSlots + 63) / 64 :
+                (mateSize * sizeof(Mate) + sizeof(Word) - 1) / sizeof(Word));
+    }
+
+    int getRoot(Count& count, Word* a) const {
+        int const v0 = graph.edgeInfo(0).v0;
+        Mate* mate = compact ? &work[0] : reinterpret_cast<Mate*>(a);
+
+        count = Count(numUEC);
+
+        if (!compact) a[getArraySize() - 1] = 0; // padding
+        for (int i = 0; i < mateSize; ++i) {
+            mate[i] = initialMate[v0 + i];
+        }
+
+        if (compact) encode(mate, a);
+        return n;
+    }
+
+    int getChild(Count& count, Word* a, int level, int take) const {
+        if (!compact) {
+            return advance(count, reinterpret_cast<Mate*>(a), level, take);
+        }
+
+        Mate* mate = &work[0];
+        decode(a, mate);
+        int const i = advance(count, mate, level, take);
+        if (i > 0) encode(mate, a);
+        return i;
+    }
+
     size_t hashCode(Count const& count) const {
         return count.hash();
     }
+
+    void printState(std::ostream& os, Count const& count,
+            Word const* a) const {
+        Mate const* mate = reinterpret_cast<Mate const*>(a);
+        if (compact) {
+            decode(a, &work[0]);
+            mate = &work[0];
+        }
+        os << "[" << count << ":";
+        for (int i = 0; i < mateSize; ++i) {
+            if (i > 0) os << ",";
+            os << mate[i];
+        }
+        os << "]";
+    }
 };
 
 } // namespace tdzdd
@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <map>
 #include <vector>
 
@@ -15,6 +17,19 @@
 
 namespace tdzdd {
 
+/**
+ * ZDD for the combinations satisfying linear constraints.
+ * A state has the partial sum of each constraint in progress.
+ * For integral types, every partial sum is replaced by the smallest one
+ * that satisfies the constraint with exactly the same subsets of the
+ * remaining items.
+ * The sums that the remaining items can add are enumerated as long as
+ * there are at most MAX_FUTURE_SUMS of them and the tables of all the
+ * constraints hold at most MAX_TOTAL_FUTURE_SUMS in total; otherwise they are
+ * approximated by the multiples of the GCD of the remaining weights
+ * between their minimum and maximum.
+ * @tparam T data type of weights.
+ */
 template<typename T>
 class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T,2> {
     struct CheckItem {
@@ -25,6 +40,9 @@ class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T,2> {
         T lowerBound;
         T upperBound;
         bool finalChoice;
+        T step;          ///< GCD of the remaining weights.
+        size_t sumBegin; ///< start of the future sums in futureSums.
+        size_t sumEnd;   ///< end of the future sums; no table if equal.
 
         CheckItem(int i,
                   T const& w,
@@ -32,14 +50,20 @@ class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T,2> {
                   T const& max,
                   T const& lb,
                   T const& ub,
-                  bool fc) :
+                  bool fc,
+                  T const& g,
+                  size_t sb,
+                  size_t se) :
                 index(i),
                 weight(w),
                 addMin(min),
                 addMax(max),
                 lowerBound(lb),
                 upperBound(ub),
-                finalChoice(fc) {
+                finalChoice(fc),
+                step(g),
+                sumBegin(sb),
+                sumEnd(se) {
         }
     };
 
@@ -47,10 +71,162 @@ class LinearConstraints: public PodArrayDdSpec<LinearConstraints<T>,T,2> {
 
     int const n;
     std::vector<Checklist> checklists;
+    std::vector<T> futureSums; ///< sorted subset sums of remaining items.
     int arraySize;
     int constraintId;
     bool isFalse;
 
+    /*
+     * The check items in structure-of-arrays form, level by level,
+     * where levelBegin[i] is the position of the first one of level i.
+     * A partial sum v after the update fails if v < failLow or
+     * failHigh < v, fully satisfies the constraint if fullLow <= v <= fullHigh,
+     * where it becomes fullLow, and is already the smallest equivalent one if
+     * keepLow1 <= v <= keepHigh1 or keepLow2 <= v <= keepHigh2.
+     */
+    std::vector<size_t> levelBegin;
+    std::vector<int> laneIndex;
+    std::vector<T> laneWeight;
+    std::vector<T> laneFailLow;
+    std::vector<T> laneFailHigh;
+    std::vector<T> laneFullLow;
+    std::vector<T> laneFullHigh;
+    std::vector<T> laneKeepLow1;
+    std::vector<T> laneKeepHigh1;
+    std::vector<T> laneKeepLow2;
+    std::vector<T> laneKeepHigh2;
+    std::vector<unsigned char> laneFinal;
+    mutable std::vector<T> work;
+    mutable std::vector<unsigned char> slow;
+
+public:
+    /// Maximum number of future sums enumerated for a check item.
+    static size_t const MAX_FUTURE_SUMS = size_t(1) << 16;
+
+    /// Maximum number of future sums held for all the check items.
+    static size_t const MAX_TOTAL_FUTURE_SUMS = size_t(1) << 20;
+
+private:
+    /**
+     * Replaces a partial sum by the smallest equivalent one.
+     * @param v the partial sum.
+     * @param t the check item with the table of future sums.
+     * @return false if no subset of the remaining items satisfies
+     *         the constraint.
+     */
+    bool snap(T& v, CheckItem const& t) const {
+        T const* s0 = &futureSums[t.sumBegin];
+        T const* sz = s0 + (t.sumEnd - t.sumBegin);
+        T const* a = std::lower_bound(s0, sz, t.lowerBound - v);
+        T const* b = std::upper_bound(a, sz, t.upperBound - v);
+        if (a == b) return false;
+
+        // the smallest v' for which exactly *a, ..., *(b-1) are feasible
+        T c = t.lowerBound - *a;
+        if (b != sz && c < t.upperBound - *b + 1) c = t.upperBound - *b + 1;
+        v = c;
+        return true;
+    }
+
+    // also compiles for non-integral T, where it is never called
+    static T mod(T const& x, T const& g) {
+        return x - x / g * g;
+    }
+
+    static T floorTo(T const& x, T const& g) {
+        T q = x / g;
+        if (mod(x, g) != 0 && x < 0) --q;
+        return q * g;
+    }
+
+    /**
+     * Replaces a partial sum by the smallest equivalent one with respect to
+     * the multiples of the step between addMin and addMax,
+     * which include all the future sums.
+     * @param v the partial sum.
+     * @param t the check item.
+     * @return false if no future sum satisfies the constraint.
+     */
+    bool snapToStep(T& v, CheckItem const& t) const {
+        T const& g = t.step;
+        T const lo = t.lowerBound - v;
+        T const hi = t.upperBound - v;
+        T const a = (lo <= t.addMin) ? t.addMin : -floorTo(-lo, g);
+        if (a > hi || a > t.addMax) return false;
+
+        T c = t.lowerBound - a;
+        if (hi < t.addMax) {
+            T const b = floorTo(hi, g) + g;
+            if (c < t.upperBound - b + 1) c = t.upperBound - b + 1;
+        }
+        v = c;
+        return true;
+    }
+
+    static T lowest() {
+        return std::numeric_limits<T>::is_integer ?
+                std::numeric_limits<T>::min() : -std::numeric_limits<T>::max();
+    }
+
+    /**
+     * Finds the partial sums that snapping leaves unchanged.
+     * They are those for which the lower end of the feasible range or
+     * the next of its upper end is in a run of consecutive future sums.
+     * @param t the check item.
+     * @param low1 the lower end of the first range.
+     * @param high1 the upper end of the first range.
+     * @param low2 the lower end of the second range.
+     * @param high2 the upper end of the second range.
+     */
+    void keepRanges(CheckItem const& t, T& low1, T& high1, T& low2,
+            T& high2) const {
+        low1 = low2 = 1;
+        high1 = high2 = 0;
+
+        if (t.finalChoice || !std::numeric_limits<T>::is_integer) {
+            low1 = lowest();
+            high1 = std::numeric_limits<T>::max();
+            return;
+        }
+        if (t.step != 1) return;
+
+        T dl = t.addMin;
+        T dh = t.addMax;
+        if (t.sumBegin != t.sumEnd) { // the longest run in the table
+            T const* p = &futureSums[t.sumBegin];
+            size_t const m = t.sumEnd - t.sumBegin;
+            size_t best = 0;
+            for (size_t i = 0, j = 1; j <= m; ++j) {
+                if (j < m && p[j] == p[j - 1] + 1) continue;
+                if (j - i > best) {
+                    best = j - i;
+                    dl = p[i];
+                    dh = p[j - 1];
+                }
+                i = j;
+            }
+        }
+
+        low1 = t.lowerBound - dh;
+        high1 = t.lowerBound - dl;
+        if (dl < dh) {
+            low2 = t.upperBound - dh + 1;
+            high2 = t.upperBound - dl;
+        }
+    }
+
+    /**
+     * Snaps a partial sum that is not handled in the vector loop.
+     * @param v the partial sum.
+     * @param t the check item.
+     * @return false if no future sum satisfies the constraint.
+     */
+    bool snapItem(T& v, CheckItem const& t) const {
+        if (t.sumBegin != t.sumEnd) return snap(v, t);
+        if (std::numeric_limits<T>::is_integer) return snapToStep(v, t);
+        return true;
+    }
+
 public:
     LinearConstraints(int n) :
             n(n),
@@ -81,18 +257,57 @@ public:
         min = 0;
         max = 0;
         bool fc = true;
+        T g = 0;
+        std::vector<T> sums(1, T(0));
+        std::vector<T> tmp;
+        bool enumerable = std::numeric_limits<T>::is_integer;
         for (typename std::map<int,T>::const_iterator t = expr.begin();
                 t != expr.end(); ++t) {
             Checklist& list = checklists[t->first];
             T const& w = t->second;
-            list.push_back(CheckItem(constraintId, w, min, max, lb, ub, fc));
+            size_t sb = futureSums.size();
+            if (enumerable && sb + sums.size() > MAX_TOTAL_FUTURE_SUMS) {
+                enumerable = false;
+            }
+            if (enumerable) {
+                futureSums.insert(futureSums.end(), sums.begin(), sums.end());
+
+                tmp.resize(sums.size());
+                for (size_t k = 0; k < sums.size(); ++k) {
+                    tmp[k] = sums[k] + w;
+                }
+                std::vector<T> merged(sums.size() * 2);
+                merged.erase(std::set_union(sums.begin(), sums.end(),
+                        tmp.begin(), tmp.end(), merged.begin()),
+                        merged.end());
+                sums.swap(merged);
+                enumerable = sums.size() <= MAX_FUTURE_SUMS;
+            }
+            list.push_back(CheckItem(constraintId, w, min, max, lb, ub, fc, g,
+                    sb, futureSums.size()));
             if (w > 0) max += w;
             else if (w < 0) min += w;
             fc = false;
+            if (std::numeric_limits<T>::is_integer) {
+                T r = (w < 0) ? -w : w;
+                while (r != 0) {
+                    T x = mod(g, r);
+                    g = r;
+                    r = x;
+                }
+            }
         }
         ++constraintId;
     }
 
+    /**
+     * Gets the number of future sums held for all the check items.
+     * @return the number of future sums.
+     */
+    size_t numFutureSums() const {
+        return futureSums.size();
+    }
+
     void update() {
         std::vector<int> indexMap(constraintId);
         for (int id = 0; id < constraintId; ++id) {
@@ -129,6 +344,61 @@ public:
         }
 
         this->setArraySize(arraySize);
+
+        size_t total = 0;
+        for (int i = 1; i <= n; ++i) {
+            total += checklists[i].size();
+        }
+        levelBegin.assign(n + 2, 0);
+        laneIndex.clear();
+        laneIndex.reserve(total);
+        laneWeight.clear();
+        laneWeight.reserve(total);
+        laneFailLow.clear();
+        laneFailLow.reserve(total);
+        laneFailHigh.clear();
+        laneFailHigh.reserve(total);
+        laneFullLow.clear();
+        laneFullLow.reserve(total);
+        laneFullHigh.clear();
+        laneFullHigh.reserve(total);
+        laneKeepLow1.clear();
+        laneKeepLow1.reserve(total);
+        laneKeepHigh1.clear();
+        laneKeepHigh1.reserve(total);
+        laneKeepLow2.clear();
+        laneKeepLow2.reserve(total);
+        laneKeepHigh2.clear();
+        laneKeepHigh2.reserve(total);
+        laneFinal.clear();
+        laneFinal.reserve(total);
+
+        size_t width = 0;
+        for (int i = 1; i <= n; ++i) {
+            Checklist const& list = checklists[i];
+            levelBegin[i] = laneIndex.size();
+            if (list.size() > width) width = list.size();
+
+            for (typename Checklist::const_iterator t = list.begin();
+                    t != list.end(); ++t) {
+                T low1, high1, low2, high2;
+                keepRanges(*t, low1, high1, low2, high2);
+                laneIndex.push_back(t->index);
+                laneWeight.push_back(t->weight);
+                laneFailLow.push_back(t->lowerBound - t->addMax);
+                laneFailHigh.push_back(t->upperBound - t->addMin);
+                laneFullLow.push_back(t->lowerBound - t->addMin);
+                laneFullHigh.push_back(t->upperBound - t->addMax);
+                laneKeepLow1.push_back(low1);
+                laneKeepHigh1.push_back(high1);
+                laneKeepLow2.push_back(low2);
+                laneKeepHigh2.push_back(high2);
+                laneFinal.push_back(t->finalChoice);
+            }
+        }
+        levelBegin[n + 1] = laneIndex.size();
+        work.resize(width);
+        slow.resize(width);
     }
 
     int getRoot(T* value) const {
@@ -142,22 +412,68 @@ public:
     }
 
     int getChild(T* value, int level, bool take) const {
-        Checklist const& list = checklists[level];
+        size_t const b = levelBegin[level];
+        size_t const m = levelBegin[level + 1] - b;
+        if (m == 0) return (--level >= 1) ? level : -1;
+
+        int const* const index = &laneIndex[b];
+        T* const x = &work[0];
+        unsigned char* const sl = &slow[0];
+        for (size_t k = 0; k < m; ++k) {
+            x[k] = value[index[k]];
+        }
+
+        // branch-free update and classification over contiguous arrays
+        T const* const weight = &laneWeight[b];
+        T const* const failLow = &laneFailLow[b];
+        T const* const failHigh = &laneFailHigh[b];
+        T const* const fullLow = &laneFullLow[b];
+        T const* const fullHigh = &laneFullHigh[b];
+        T const* const keepLow1 = &laneKeepLow1[b];
+        T const* const keepHigh1 = &laneKeepHigh1[b];
+        T const* const keepLow2 = &laneKeepLow2[b];
+        T const* const keepHigh2 = &laneKeepHigh2[b];
+        int bad = 0;
+        int slowCount = 0;
+        if (take) {
+            for (size_t k = 0; k < m; ++k) {
+                x[k] += weight[k];
+            }
+        }
+#if defined(_OPENMP) && _OPENMP >= 201307 // simd needs OpenMP 4.0
+#pragma omp simd reduction(|:bad) reduction(+:slowCount)
+#endif
+        for (size_t k = 0; k < m; ++k) {
+            T const v = x[k];
+            bad |= (v < failLow[k]) | (failHigh[k] < v);
+            int const full = (fullLow[k] <= v) & (v <= fullHigh[k]);
+            int const keep = !std::numeric_limits<T>::is_integer ? 1 :
+                    full | ((keepLow1[k] <= v) & (v <= keepHigh1[k]))
+                            | ((keepLow2[k] <= v) & (v <= keepHigh2[k]));
+            x[k] = full ? fullLow[k] : v;
+            sl[k] = !keep;
+            slowCount += !keep;
+        }
+        if (bad) return 0;
 
-        for (typename Checklist::const_iterator t = list.begin();
-                t != list.end(); ++t) {
-            T& v = value[t->index];
-            if (take) v += t->weight;
-            if (v + t->addMax < t->lowerBound || t->upperBound < v + t->addMin)
-                return 0;
-            if (t->lowerBound <= v + t->addMin
-                && v + t->addMax <= t->upperBound) // state compression
-            v = t->lowerBound - t->addMin;
-            if (t->finalChoice) v = 0;
+        unsigned char const* const final = &laneFinal[b];
+        if (slowCount) {
+            CheckItem const* const items = &checklists[level][0];
+            for (size_t k = 0; k < m; ++k) {
+                if (sl[k] && !snapItem(x[k], items[k])) return 0;
+            }
+        }
+        for (size_t k = 0; k < m; ++k) {
+            value[index[k]] = final[k] ? T(0) : x[k];
         }
 
         return (--level >= 1) ? level : -1;
     }
 };
 
+template<typename T>
+size_t const LinearConstraints<T>::MAX_FUTURE_SUMS;
+template<typename T>
+size_t const LinearConstraints<T>::MAX_TOTAL_FUTURE_SUMS;
+
 } // namespace tdzdd
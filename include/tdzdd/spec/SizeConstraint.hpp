@@ -24,7 +24,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <iostream>
 
 #include "../DdSpec.hpp"
@@ -35,35 +37,60 @@ namespace tdzdd {
 class SizeConstraint: public DdSpec<SizeConstraint,int,2> {
     int const n;
     IntSubset const* const constraint;
+    int lower;     ///< lower bound of the constraint.
+    int upper;     ///< upper bound of the constraint.
+    bool interval; ///< constraint has all sizes between its bounds.
+
+    void init() {
+        lower = 0;
+        upper = INT_MAX;
+        interval = false;
+        if (constraint == 0) return;
+        lower = constraint->lowerBound();
+        upper = constraint->upperBound();
+        int const ub = std::min(upper, n);
+        for (int x = lower; x <= ub; ++x) {
+            if (!constraint->contains(x)) return;
+        }
+        interval = true;
+    }
 
 public:
     SizeConstraint(int n, IntSubset const& constraint)
             : n(n), constraint(&constraint) {
         assert(n >= 1);
+        init();
     }
 
     SizeConstraint(int n, IntSubset const* constraint)
             : n(n), constraint(constraint) {
         assert(n >= 1);
+        init();
     }
 
     int getRoot(int& count) const {
         count = 0;
-        return (constraint && n < constraint->lowerBound()) ? 0 : n;
+        return (constraint && n < lower) ? 0 : n;
     }
 
     int getChild(int& count, int level, int value) const {
         if (constraint == 0) return (--level >= 1) ? level : -1;
 
         if (value) {
-            if (count >= constraint->upperBound()) return 0;
+            if (count >= upper) return 0;
             ++count;
         }
         else {
-            if (count + level <= constraint->lowerBound()) return 0;
+            if (count + level <= lower) return 0;
         }
 
-        return (--level >= 1) ? level : constraint->contains(count) ? -1 : 0;
+        if (--level < 1) return constraint->contains(count) ? -1 : 0;
+
+        // all the counts that accept any choices from now on are equivalent
+        if (interval && count >= lower && count + level <= upper) {
+            count = lower;
+        }
+        return level;
     }
 };
 
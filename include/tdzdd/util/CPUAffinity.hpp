@@ -0,0 +1,265 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace tdzdd {
+
+/**
+ * Opt-in placement of the threads of the MP algorithms on NUMA nodes.
+ * When enabled, the k-th thread is bound to a CPU of node k mod N,
+ * where N is the number of nodes, so that the per-thread states, hash
+ * tables and output slices which the thread touches first are
+ * allocated on its node by the first-touch policy of the kernel.
+ * The topology is read from /sys/devices/system/node within the CPUs
+ * allowed for the process; binding does nothing on other platforms.
+ * An object binds its thread for its own lifetime and gives back the
+ * original affinity of the thread when it is destroyed.
+ */
+class CPUAffinity {
+    struct Topology {
+        std::vector<int> cpus;   ///< CPUs in the order of binding.
+        std::vector<int> nodeOf; ///< Node of each CPU.
+        int nodes;               ///< The number of nodes.
+
+        Topology() :
+                nodes(1) {
+        }
+    };
+
+#ifdef __linux__
+    cpu_set_t saved; ///< The affinity of the thread before binding.
+#endif
+    bool bound;
+
+    CPUAffinity(CPUAffinity const&);
+    CPUAffinity& operator=(CPUAffinity const&);
+
+    static bool& flag() {
+        static bool f = false;
+        return f;
+    }
+
+    static Topology& topology() {
+        static Topology t;
+        return t;
+    }
+
+    static std::vector<int> parseList(std::string const& s) {
+        std::vector<int> v;
+        std::istringstream is(s);
+        std::string item;
+        while (std::getline(is, item, ',')) {
+            if (item.empty() || item[0] < '0' || '9' < item[0]) continue;
+            size_t d = item.find('-');
+            int a = std::atoi(item.c_str());
+            int b = (d == std::string::npos) ?
+                    a : std::atoi(item.c_str() + d + 1);
+            for (int k = a; k <= b; ++k) {
+                v.push_back(k);
+            }
+        }
+        return v;
+    }
+
+    static std::string readLine(std::string const& path) {
+        std::ifstream ifs(path.c_str());
+        std::string s;
+        std::getline(ifs, s);
+        return s;
+    }
+
+    static void load() {
+        Topology& t = topology();
+        t = Topology();
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+
+        std::string const dir = "/sys/devices/system/node/";
+        std::vector<int> nodes = parseList(readLine(dir + "online"));
+        std::vector<std::vector<int> > cpusOf;
+        for (size_t k = 0; k < nodes.size(); ++k) {
+            std::ostringstream path;
+            path << dir << "node" << nodes[k] << "/cpulist";
+            std::vector<int> cpus = parseList(readLine(path.str()));
+            std::vector<int> usable;
+            for (size_t j = 0; j < cpus.size(); ++j) {
+                if (cpus[j] < CPU_SETSIZE && CPU_ISSET(cpus[j], &allowed)) {
+                    usable.push_back(cpus[j]);
+                }
+            }
+            if (!usable.empty()) cpusOf.push_back(usable);
+        }
+
+        if (cpusOf.empty()) { // no sysfs: one node of the allowed CPUs
+            cpusOf.resize(1);
+            for (int c = 0; c < CPU_SETSIZE; ++c) {
+                if (CPU_ISSET(c, &allowed)) cpusOf[0].push_back(c);
+            }
+        }
+
+        for (size_t r = 0;; ++r) {
+            bool found = false;
+            for (size_t k = 0; k < cpusOf.size(); ++k) {
+                if (r >= cpusOf[k].size()) continue;
+                int c = cpusOf[k][r];
+                t.cpus.push_back(c);
+                if (int(t.nodeOf.size()) <= c) t.nodeOf.resize(c + 1, 0);
+                t.nodeOf[c] = k;
+                found = true;
+            }
+            if (!found) break;
+        }
+        t.nodes = cpusOf.size();
+#endif
+    }
+
+public:
+    CPUAffinity() :
+            bound(false) {
+    }
+
+    ~CPUAffinity() {
+#ifdef __linux__
+        if (bound) sched_setaffinity(0, sizeof(saved), &saved);
+#endif
+    }
+
+    /**
+     * Starts or stops binding threads.
+     * The topology is read when it is started.
+     * @param on true to start binding.
+     */
+    static void enable(bool on = true) {
+        if (on) load();
+        flag() = on;
+    }
+
+    /**
+     * Checks if binding is active.
+     * @return true if binding is active.
+     */
+    static bool enabled() {
+        return flag();
+    }
+
+    /**
+     * Gets the number of NUMA nodes used for binding.
+     * @return the number of nodes.
+     */
+    static int numNodes() {
+        return topology().nodes;
+    }
+
+    /**
+     * Gets the NUMA node of the CPU running the calling thread.
+     * @return the index of the node among those used for binding.
+     */
+    static int currentNode() {
+#ifdef __linux__
+        std::vector<int> const& nodeOf = topology().nodeOf;
+        int c = sched_getcpu();
+        if (0 <= c && c < int(nodeOf.size())) return nodeOf[c];
+#endif
+        return 0;
+    }
+
+    /**
+     * Binds the calling thread to the CPU for a thread number
+     * until this object is destroyed.
+     * Nothing is done unless binding is active.
+     * @param k the thread number.
+     */
+    void bind(int k) {
+#ifdef __linux__
+        if (!enabled()) return;
+        std::vector<int> const& cpus = topology().cpus;
+        if (cpus.empty()) return;
+        if (!bound) {
+            if (sched_getaffinity(0, sizeof(saved), &saved) != 0) return;
+            bound = true;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[k % cpus.size()], &set);
+        sched_setaffinity(0, sizeof(set), &set);
+#endif
+    }
+
+    /**
+     * Gets the memory of this process resident on each NUMA node.
+     * The numbers are taken from /proc/self/numa_maps.
+     * @return the bytes indexed by the node ID of the system,
+     *         or an empty vector if they are not available.
+     */
+    static std::vector<uint64_t> memoryPerNode() {
+        std::vector<uint64_t> bytes;
+        std::ifstream ifs("/proc/self/numa_maps");
+        std::string line;
+        std::vector<uint64_t> pages;
+
+        while (std::getline(ifs, line)) {
+            std::istringstream is(line);
+            std::string token;
+            uint64_t pageSize = 4096;
+            pages.clear();
+            while (is >> token) {
+                if (token.compare(0, 18, "kernelpagesize_kB=") == 0) {
+                    pageSize = std::strtoull(token.c_str() + 18, 0, 10) << 10;
+                }
+                else if (token.size() >= 3 && token[0] == 'N'
+                        && '0' <= token[1] && token[1] <= '9') {
+                    size_t eq = token.find('=');
+                    if (eq == std::string::npos) continue;
+                    size_t k = std::atoi(token.c_str() + 1);
+                    if (pages.size() <= k) pages.resize(k + 1);
+                    pages[k] += std::strtoull(token.c_str() + eq + 1, 0, 10);
+                }
+            }
+            if (bytes.size() < pages.size()) bytes.resize(pages.size());
+            for (size_t k = 0; k < pages.size(); ++k) {
+                bytes[k] += pages[k] * pageSize;
+            }
+        }
+
+        return bytes;
+    }
+};
+
+} // namespace tdzdd
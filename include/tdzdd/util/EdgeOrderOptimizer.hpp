@@ -0,0 +1,618 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "Graph.hpp"
+#include "MessageHandler.hpp"
+
+namespace tdzdd {
+
+/**
+ * Edge order optimizer that reduces the frontier size of a graph.
+ * Vertex orders are generated by BFS, Cuthill-McKee and beam search
+ * for small vertex separation, improved by swapping adjacent vertices,
+ * and converted into edge orders.  The frontier size of an edge order
+ * is evaluated exactly as Graph::update() numbers the vertices.
+ */
+class EdgeOrderOptimizer {
+public:
+    typedef Graph::VertexNumber VertexNumber;
+    typedef Graph::EdgeNumber EdgeNumber;
+
+    /**
+     * Frontier sizes of an edge order.
+     */
+    struct Score {
+        int max;     ///< The maximum frontier size.
+        int64_t sum; ///< The sum of the frontier sizes over the edges.
+
+        Score() :
+                max(INT_MAX), sum(INT64_MAX) {
+        }
+
+        bool operator<(Score const& o) const {
+            return max != o.max ? max < o.max : sum < o.sum;
+        }
+    };
+
+private:
+    /* Work limit of beam search and local improvement. */
+    static uint64_t const WORK_BUDGET = uint64_t(1) << 28;
+
+    int const n;                      ///< The number of vertices.
+    int const m;                      ///< The number of edges.
+    std::vector<VertexNumber> end1;   ///< The first endpoint of each edge.
+    std::vector<VertexNumber> end2;   ///< The second endpoint of each edge.
+    std::vector<int> adjStart;        ///< CSR index of the adjacency.
+    std::vector<VertexNumber> adj;    ///< Neighbors of the vertices.
+
+    std::vector<EdgeNumber> bestOrder;
+    Score bestScore;
+    std::string bestMethod;
+
+    mutable std::vector<int> lastEdge;
+    mutable std::vector<int> number;
+    mutable std::vector<VertexNumber> byNumber;
+    mutable std::vector<int> count;
+    mutable std::vector<EdgeNumber> tmpOrder;
+
+    int degree(VertexNumber v) const {
+        return adjStart[v + 1] - adjStart[v];
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param graph the graph.
+     */
+    EdgeOrderOptimizer(Graph const& graph) :
+            n(graph.vertexSize()), m(graph.edgeSize()), end1(m), end2(m),
+            lastEdge(n + 1), number(n + 1), byNumber(n + 2),
+            count(n + 2) {
+        std::vector<int> deg(n + 2);
+        for (EdgeNumber a = 0; a < m; ++a) {
+            std::pair<std::string,std::string> name = graph.edgeName(a);
+            end1[a] = graph.getVertex(name.first);
+            end2[a] = graph.getVertex(name.second);
+            if (end1[a] != end2[a]) {
+                ++deg[end1[a]];
+                ++deg[end2[a]];
+            }
+        }
+
+        adjStart.resize(n + 2);
+        adjStart[0] = adjStart[1] = 0;
+        for (VertexNumber v = 1; v <= n; ++v) {
+            adjStart[v + 1] = adjStart[v] + deg[v];
+        }
+        adj.resize(adjStart[n + 1]);
+        for (EdgeNumber a = 0; a < m; ++a) {
+            VertexNumber v1 = end1[a];
+            VertexNumber v2 = end2[a];
+            if (v1 == v2) continue;
+            adj[adjStart[v1 + 1] - deg[v1]--] = v2;
+            adj[adjStart[v2 + 1] - deg[v2]--] = v1;
+        }
+
+        bestOrder.resize(m);
+        for (EdgeNumber a = 0; a < m; ++a) {
+            bestOrder[a] = a;
+        }
+        bestScore = evaluate(bestOrder);
+        bestMethod = "input";
+    }
+
+    /**
+     * Evaluates an edge order.
+     * @param order the edge numbers in the order.
+     * @return the frontier sizes.
+     */
+    Score evaluate(std::vector<EdgeNumber> const& order) const {
+        Score s;
+        s.max = 0;
+        s.sum = 0;
+        if (m == 0) return s;
+
+        for (int i = 0; i < m; ++i) {
+            lastEdge[end1[order[i]]] = i;
+            lastEdge[end2[order[i]]] = i;
+        }
+
+        /* Vertices are numbered by their last edges. */
+        std::fill(number.begin(), number.end(), 0);
+        int k = 0;
+        for (int i = 0; i < m; ++i) {
+            VertexNumber v1 = end1[order[i]];
+            VertexNumber v2 = end2[order[i]];
+            if (lastEdge[v1] == i && number[v1] == 0) {
+                number[v1] = ++k;
+                byNumber[k] = v1;
+            }
+            if (lastEdge[v2] == i && number[v2] == 0) {
+                number[v2] = ++k;
+                byNumber[k] = v2;
+            }
+        }
+
+        VertexNumber v0 = 1;
+        for (int i = 0; i < m; ++i) {
+            while (lastEdge[byNumber[v0]] < i) {
+                ++v0;
+            }
+            int size = std::max(number[end1[order[i]]], number[end2[order[i]]])
+                    - v0 + 1;
+            if (s.max < size) s.max = size;
+            s.sum += size;
+        }
+        return s;
+    }
+
+private:
+    /*
+     * Sorts the edges by the position of an endpoint in a vertex order,
+     * the later one first if byLater is set, and the other one next.
+     */
+    void edgeOrder(std::vector<EdgeNumber>& order,
+            std::vector<int> const& pos, bool byLater) const {
+        order.resize(m);
+        tmpOrder.resize(m);
+
+        for (int pass = 0; pass < 2; ++pass) {
+            bool later = (pass == 0) != byLater;
+            std::fill(count.begin(), count.end(), 0);
+            for (EdgeNumber a = 0; a < m; ++a) {
+                int p1 = pos[end1[a]], p2 = pos[end2[a]];
+                ++count[(later ? std::max(p1, p2) : std::min(p1, p2)) + 1];
+            }
+            for (int p = 1; p <= n + 1; ++p) {
+                count[p] += count[p - 1];
+            }
+
+            for (int i = 0; i < m; ++i) {
+                EdgeNumber a = (pass == 0) ? i : tmpOrder[i];
+                int p1 = pos[end1[a]], p2 = pos[end2[a]];
+                int key = later ? std::max(p1, p2) : std::min(p1, p2);
+                ((pass == 0) ? tmpOrder : order)[count[key]++] = a;
+            }
+        }
+    }
+
+    /*
+     * Converts a vertex order into the better edge order and records it.
+     */
+    Score tryVertexOrder(std::vector<VertexNumber> const& vorder,
+            std::string const& method, bool* byLater = 0) {
+        std::vector<int> pos(n + 1);
+        for (int i = 0; i < n; ++i) {
+            pos[vorder[i]] = i;
+        }
+
+        Score best;
+        std::vector<EdgeNumber> order;
+        for (int b = 0; b < 2; ++b) {
+            edgeOrder(order, pos, b);
+            Score s = evaluate(order);
+            if (s < best) {
+                best = s;
+                if (byLater) *byLater = b;
+            }
+            if (s < bestScore) {
+                bestScore = s;
+                bestOrder = order;
+                bestMethod = method;
+            }
+        }
+        return best;
+    }
+
+    /*
+     * Finds a vertex far from the given one in its connected component.
+     */
+    VertexNumber pseudoPeripheral(VertexNumber v) const {
+        std::vector<int> dist(n + 1, -1);
+        std::vector<VertexNumber> queue;
+        int ecc = -1;
+
+        for (int iter = 0; iter < 8; ++iter) {
+            for (size_t k = 0; k < queue.size(); ++k) {
+                dist[queue[k]] = -1;
+            }
+            queue.clear();
+            queue.push_back(v);
+            dist[v] = 0;
+            for (size_t k = 0; k < queue.size(); ++k) {
+                VertexNumber u = queue[k];
+                for (int j = adjStart[u]; j < adjStart[u + 1]; ++j) {
+                    VertexNumber w = adj[j];
+                    if (dist[w] >= 0) continue;
+                    dist[w] = dist[u] + 1;
+                    queue.push_back(w);
+                }
+            }
+
+            int d = dist[queue.back()];
+            if (d <= ecc) break;
+            ecc = d;
+
+            VertexNumber far = queue.back();
+            for (size_t k = queue.size(); k > 0 && dist[queue[k - 1]] == d;
+                    --k) {
+                if (degree(queue[k - 1]) < degree(far)) far = queue[k - 1];
+            }
+            v = far;
+        }
+        return v;
+    }
+
+    /*
+     * Breadth-first vertex order; neighbors are visited in the order of
+     * their degrees if byDegree is set (Cuthill-McKee).
+     */
+    std::vector<VertexNumber> breadthFirst(bool byDegree) const {
+        std::vector<VertexNumber> order;
+        std::vector<bool> visited(n + 1);
+        std::vector<VertexNumber> next;
+        order.reserve(n);
+
+        for (VertexNumber s = 1; s <= n; ++s) {
+            if (visited[s]) continue;
+            VertexNumber v = pseudoPeripheral(s);
+            visited[v] = true;
+            order.push_back(v);
+
+            for (size_t k = order.size() - 1; k < order.size(); ++k) {
+                VertexNumber u = order[k];
+                next.clear();
+                for (int j = adjStart[u]; j < adjStart[u + 1]; ++j) {
+                    VertexNumber w = adj[j];
+                    if (visited[w]) continue;
+                    visited[w] = true;
+                    next.push_back(w);
+                }
+                if (byDegree) {
+                    for (size_t i = 1; i < next.size(); ++i) {
+                        VertexNumber w = next[i];
+                        size_t j = i;
+                        for (; j > 0 && degree(next[j - 1]) > degree(w); --j) {
+                            next[j] = next[j - 1];
+                        }
+                        next[j] = w;
+                    }
+                }
+                order.insert(order.end(), next.begin(), next.end());
+            }
+        }
+        return order;
+    }
+
+    struct BeamState {
+        std::vector<char> placed;
+        std::vector<int> rest;              ///< The number of unplaced neighbors.
+        std::vector<VertexNumber> frontier; ///< Placed vertices with rest > 0.
+        std::vector<int> index;             ///< Position in the frontier.
+        std::vector<VertexNumber> order;
+        size_t next;                        ///< Scan position in the hint.
+        int maxSize;
+        int64_t sum;
+    };
+
+    struct BeamMove {
+        int parent;
+        VertexNumber v;
+        int maxSize;
+        int64_t sum;
+        int size;
+        int rest;
+        int rank;
+
+        bool operator<(BeamMove const& o) const {
+            if (maxSize != o.maxSize) return maxSize < o.maxSize;
+            if (sum != o.sum) return sum < o.sum;
+            if (size != o.size) return size < o.size;
+            if (rest != o.rest) return rest < o.rest;
+            return rank < o.rank;
+        }
+    };
+
+    void place(BeamState& s, VertexNumber v) const {
+        s.placed[v] = true;
+        s.order.push_back(v);
+        for (int j = adjStart[v]; j < adjStart[v + 1]; ++j) {
+            VertexNumber u = adj[j];
+            --s.rest[u];
+            if (s.placed[u] && s.rest[u] == 0) {
+                VertexNumber last = s.frontier.back();
+                s.frontier[s.index[u]] = last;
+                s.index[last] = s.index[u];
+                s.frontier.pop_back();
+            }
+        }
+        if (s.rest[v] > 0) {
+            s.index[v] = s.frontier.size();
+            s.frontier.push_back(v);
+        }
+        int size = s.frontier.size();
+        if (s.maxSize < size) s.maxSize = size;
+        s.sum += size;
+    }
+
+    /*
+     * Beam search for a vertex order with a small vertex separation.
+     * Ties are broken by the given order.
+     */
+    std::vector<VertexNumber> beamSearch(int width,
+            std::vector<VertexNumber> const& hint) const {
+        std::vector<int> rank(n + 1);
+        for (int i = 0; i < n; ++i) {
+            rank[hint[i]] = i;
+        }
+
+        std::vector<BeamState> beam(1);
+        beam[0].placed.assign(n + 1, false);
+        beam[0].rest.resize(n + 1);
+        for (VertexNumber v = 1; v <= n; ++v) {
+            beam[0].rest[v] = degree(v);
+        }
+        beam[0].index.resize(n + 1);
+        beam[0].order.reserve(n);
+        beam[0].next = 0;
+        beam[0].maxSize = 0;
+        beam[0].sum = 0;
+
+        std::vector<int> stamp(n + 1, -1);
+        std::vector<BeamMove> moves;
+        int stampCount = 0;
+
+        for (int step = 0; step < n; ++step) {
+            moves.clear();
+            for (int p = 0; p < int(beam.size()); ++p) {
+                BeamState& s = beam[p];
+                ++stampCount;
+                for (size_t k = 0; k < s.frontier.size(); ++k) {
+                    VertexNumber f = s.frontier[k];
+                    for (int j = adjStart[f]; j < adjStart[f + 1]; ++j) {
+                        VertexNumber v = adj[j];
+                        if (s.placed[v] || stamp[v] == stampCount) continue;
+                        stamp[v] = stampCount;
+
+                        BeamMove mv;
+                        mv.parent = p;
+                        mv.v = v;
+                        mv.rest = s.rest[v];
+                        mv.size = s.frontier.size() + (s.rest[v] > 0);
+                        for (int i = adjStart[v]; i < adjStart[v + 1]; ++i) {
+                            VertexNumber u = adj[i];
+                            if (s.placed[u] && s.rest[u] == 1) --mv.size;
+                        }
+                        mv.maxSize = std::max(s.maxSize, mv.size);
+                        mv.sum = s.sum + mv.size;
+                        mv.rank = rank[v];
+                        moves.push_back(mv);
+                    }
+                }
+
+                if (s.frontier.empty()) {
+                    /* A new connected component starts at the first
+                     * unplaced vertex of the hint. */
+                    while (s.placed[hint[s.next]]) {
+                        ++s.next;
+                    }
+                    BeamMove mv;
+                    mv.parent = p;
+                    mv.v = hint[s.next];
+                    mv.rest = s.rest[mv.v];
+                    mv.size = (mv.rest > 0);
+                    mv.maxSize = std::max(s.maxSize, mv.size);
+                    mv.sum = s.sum + mv.size;
+                    mv.rank = rank[mv.v];
+                    moves.push_back(mv);
+                }
+            }
+
+            size_t k = std::min(moves.size(), size_t(width));
+            std::partial_sort(moves.begin(), moves.begin() + k, moves.end());
+            moves.resize(k);
+
+            std::vector<int> uses(beam.size());
+            for (size_t i = 0; i < k; ++i) {
+                ++uses[moves[i].parent];
+            }
+            std::vector<BeamState> next(k);
+            for (size_t i = 0; i < k; ++i) {
+                BeamState& s = beam[moves[i].parent];
+                if (--uses[moves[i].parent] == 0) {
+                    std::swap(next[i].placed, s.placed);
+                    std::swap(next[i].rest, s.rest);
+                    std::swap(next[i].frontier, s.frontier);
+                    std::swap(next[i].index, s.index);
+                    std::swap(next[i].order, s.order);
+                    next[i].next = s.next;
+                    next[i].maxSize = s.maxSize;
+                    next[i].sum = s.sum;
+                }
+                else {
+                    next[i] = s;
+                }
+                place(next[i], moves[i].v);
+            }
+            beam.swap(next);
+        }
+
+        return beam[0].order;
+    }
+
+    /*
+     * Swaps adjacent vertices while the frontier size decreases.
+     */
+    void improve(std::vector<VertexNumber> vorder, bool byLater,
+            int maxTrials) {
+        std::vector<int> pos(n + 1);
+        for (int i = 0; i < n; ++i) {
+            pos[vorder[i]] = i;
+        }
+        std::vector<EdgeNumber> order;
+        edgeOrder(order, pos, byLater);
+        Score cur = evaluate(order);
+
+        int trials = 0;
+        bool improved = true;
+        while (improved && trials < maxTrials) {
+            improved = false;
+            for (int i = 0; i + 1 < n && trials < maxTrials; ++i, ++trials) {
+                std::swap(pos[vorder[i]], pos[vorder[i + 1]]);
+                edgeOrder(order, pos, byLater);
+                Score s = evaluate(order);
+                if (s < cur) {
+                    cur = s;
+                    std::swap(vorder[i], vorder[i + 1]);
+                    improved = true;
+                    if (s < bestScore) {
+                        bestScore = s;
+                        bestOrder = order;
+                        bestMethod = "swap";
+                    }
+                }
+                else {
+                    std::swap(pos[vorder[i]], pos[vorder[i + 1]]);
+                }
+            }
+        }
+    }
+
+public:
+    /**
+     * Searches for a better edge order.
+     * The larger search is limited for large graphs.
+     * @param beamWidth the beam width; 0 to skip beam search.
+     * @param swapTrials the maximum number of swaps tried.
+     */
+    void optimize(int beamWidth = 8, int swapTrials = 1000) {
+        MessageHandler mh;
+        mh.begin("edge ordering");
+        report(mh, "input", bestScore);
+
+        std::vector<VertexNumber> bfs = breadthFirst(false);
+        report(mh, "bfs", tryVertexOrder(bfs, "bfs"));
+
+        std::vector<VertexNumber> cm = breadthFirst(true);
+        bool cmByLater = false;
+        Score cmScore = tryVertexOrder(cm, "cm", &cmByLater);
+        report(mh, "cm", cmScore);
+
+        std::vector<VertexNumber> rcm(cm.rbegin(), cm.rend());
+        report(mh, "rcm", tryVertexOrder(rcm, "rcm"));
+
+        std::vector<VertexNumber> seed = cm;
+        bool seedByLater = cmByLater;
+        Score seedScore = cmScore;
+
+        if (beamWidth > 0 && n > 0) {
+            uint64_t w = WORK_BUDGET / (uint64_t(n) * n + 1);
+            int width = int(std::max(uint64_t(1),
+                    std::min(uint64_t(beamWidth), w)));
+            std::vector<VertexNumber> bs = beamSearch(width, cm);
+            bool byLater = false;
+            Score s = tryVertexOrder(bs, "beam", &byLater);
+            mh << "\n" << "beam(" << width << ")";
+            report(mh, "", s);
+            if (s < seedScore) {
+                seed = bs;
+                seedByLater = byLater;
+                seedScore = s;
+            }
+        }
+
+        if (swapTrials > 0 && n > 1) {
+            uint64_t t = WORK_BUDGET / (4 * uint64_t(n + m));
+            improve(seed, seedByLater,
+                    int(std::min(uint64_t(swapTrials), t)));
+            report(mh, "swap", bestScore);
+        }
+
+        mh << "\n" << "chosen: " << bestMethod;
+        mh.end();
+    }
+
+    /**
+     * Gets the best edge order.
+     * @return the current edge numbers in the new order.
+     */
+    std::vector<EdgeNumber> const& edgeOrder() const {
+        return bestOrder;
+    }
+
+    /**
+     * Gets the name of the method that found the best edge order.
+     * @return the name.
+     */
+    std::string const& method() const {
+        return bestMethod;
+    }
+
+    /**
+     * Gets the maximum frontier size of the best edge order.
+     * @return the maximum frontier size.
+     */
+    int maxFrontierSize() const {
+        return bestScore.max;
+    }
+
+    /**
+     * Gets the average frontier size of the best edge order.
+     * @return the average frontier size.
+     */
+    double averageFrontierSize() const {
+        return m > 0 ? double(bestScore.sum) / m : 0;
+    }
+
+    /**
+     * Optimizes the edge order of a graph and applies it.
+     * @param graph the graph.
+     * @param beamWidth the beam width; 0 to skip beam search.
+     * @param swapTrials the maximum number of swaps tried.
+     */
+    static void apply(Graph& graph, int beamWidth = 8, int swapTrials = 1000) {
+        EdgeOrderOptimizer opt(graph);
+        opt.optimize(beamWidth, swapTrials);
+        graph.reorderEdges(opt.edgeOrder());
+    }
+
+private:
+    void report(MessageHandler& mh, std::string const& name,
+            Score const& s) const {
+        if (!name.empty()) mh << "\n" << name;
+        mh << ": max " << s.max << ", avg "
+           << (m > 0 ? double(s.sum) / m : 0);
+    }
+};
+
+} // namespace tdzdd
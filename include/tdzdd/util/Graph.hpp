@@ -36,8 +36,14 @@
 #include <sstream>
 #include <stdexcept>
 #include <stdint.h>
+#include <string>
 #include <vector>
 
+#include "MappedFile.hpp"
+#include "MessageHandler.hpp"
+#include "MyHashTable.hpp"
+#include "OutputBuffer.hpp"
+
 namespace tdzdd {
 
 class Graph {
@@ -82,24 +88,109 @@ public:
     static ColorNumber const MAX_COLORS = USHRT_MAX;
 
 private:
-    std::vector<std::pair<std::string,std::string> > edgeNames;
+    typedef int NameNumber;
+    typedef std::pair<NameNumber,NameNumber> NameNumberPair;
+
+    struct NameHash {
+        size_t operator()(std::string const& s) const {
+            uint64_t h = 14695981039346656037ULL;
+            for (size_t i = 0; i < s.size(); ++i) {
+                h = (h ^ static_cast<unsigned char>(s[i])) * 1099511628211ULL;
+            }
+            return h;
+        }
+
+        bool operator()(std::string const& s1, std::string const& s2) const {
+            return s1 == s2;
+        }
+    };
+
+    /* Decimal names below this bound are looked up by their values. */
+    static NameNumber const MAX_NUMBER_NAME = 1 << 22;
+
+    std::vector<std::string> names;
+    std::vector<NameNumber> number2name; // name number + 1
+    MyHashMap<std::string,NameNumber,NameHash,NameHash> string2name;
+    std::string nameBuf;
+
+    std::vector<NameNumberPair> edgeNames;
     std::map<std::string,std::string> name2label;
     std::map<std::string,std::string> name2color;
-    std::map<std::string,VertexNumber> name2vertex;
-    std::vector<std::string> vertex2name;
-    std::map<std::pair<std::string,std::string>,EdgeNumber> name2edge;
-    std::vector<std::pair<std::string,std::string> > edge2name;
+    std::vector<VertexNumber> name2vertex;
+    std::vector<NameNumber> vertex2name;
+    std::vector<NameNumberPair> edge2name;
     std::vector<EdgeInfo> edgeInfo_;
-    std::map<VertexNumberPair,EdgeNumber> edgeIndex;
+    MyHashMap<uint64_t,EdgeNumber> edgeIndex;
     std::vector<VertexNumber> virtualMate_;
     std::vector<ColorNumber> colorNumber_;
     VertexNumber vMax;
     ColorNumber numColor_;
     bool hasColorPairs_;
 
+    static int decimalValue(char const* p, size_t n) {
+        if (n == 0 || n > 7 || (p[0] == '0' && n > 1)) return -1;
+        int k = 0;
+        for (size_t i = 0; i < n; ++i) {
+            unsigned d = static_cast<unsigned char>(p[i]) - '0';
+            if (d > 9) return -1;
+            k = k * 10 + d;
+        }
+        return (k < MAX_NUMBER_NAME) ? k : -1;
+    }
+
+    NameNumber internNumber(int k) {
+        if (k < 0 || k >= MAX_NUMBER_NAME) return internName(to_string(k));
+        if (size_t(k) >= number2name.size()) number2name.resize(k + 1);
+        NameNumber& x = number2name[k];
+        if (x == 0) {
+            names.push_back(to_string(k));
+            x = names.size();
+        }
+        return x - 1;
+    }
+
+    NameNumber internName(char const* p, size_t n) {
+        int k = decimalValue(p, n);
+        if (k >= 0) return internNumber(k);
+        if (n == 0) throw std::runtime_error("ERROR: Empty vertex name");
+
+        nameBuf.assign(p, n);
+        NameNumber* found = string2name.getValue(nameBuf);
+        if (found) return *found;
+        NameNumber x = names.size();
+        names.push_back(nameBuf);
+        string2name[nameBuf] = x;
+        return x;
+    }
+
+    NameNumber internName(std::string const& name) {
+        return internName(name.data(), name.size());
+    }
+
+    NameNumber findName(std::string const& name) const {
+        int k = decimalValue(name.data(), name.size());
+        if (k >= 0) {
+            return (size_t(k) < number2name.size()) ? number2name[k] - 1 : -1;
+        }
+        if (name.empty()) return -1;
+        NameNumber const* found = string2name.getValue(name);
+        return found ? *found : -1;
+    }
+
+    VertexNumber findVertex(std::string const& name) const {
+        NameNumber x = findName(name);
+        return (0 <= x && size_t(x) < name2vertex.size()) ? name2vertex[x] : 0;
+    }
+
+    static uint64_t edgeKey(VertexNumber v1, VertexNumber v2) {
+        return (uint64_t(v1) << 32) | uint64_t(v2);
+    }
+
 public:
     void addEdge(std::string vertexName1, std::string vertexName2) {
-        edgeNames.push_back(std::make_pair(vertexName1, vertexName2));
+        edgeNames.push_back(
+                std::make_pair(internName(vertexName1),
+                        internName(vertexName2)));
     }
 
     void setColor(std::string v, std::string color) {
@@ -116,14 +207,12 @@ public:
 
         if (filename.empty()) {
             mh << " STDIN ...";
-            readEdges(std::cin);
         }
         else {
             mh << " \"" << filename << "\" ...";
-            std::ifstream fin(filename.c_str(), std::ios::in);
-            if (!fin) throw std::runtime_error(strerror(errno));
-            readEdges(fin);
         }
+        MappedFile mf(filename);
+        readEdges(mf.begin(), mf.end());
 
         mh.end();
         update();
@@ -135,14 +224,12 @@ public:
 
         if (filename.empty()) {
             mh << " STDIN ...";
-            readAdjacencyList(std::cin);
         }
         else {
             mh << " \"" << filename << "\" ...";
-            std::ifstream fin(filename.c_str(), std::ios::in);
-            if (!fin) throw std::runtime_error(strerror(errno));
-            readAdjacencyList(fin);
         }
+        MappedFile mf(filename);
+        readAdjacencyList(mf.begin(), mf.end());
 
         mh.end();
         update();
@@ -167,72 +254,268 @@ public:
         update();
     }
 
-private:
-    void readEdges(std::istream& is) {
-        std::string v, v1, v2;
+    /**
+     * Writes the graph with its frontier data to a binary cache file.
+     * The file is specific to the machine architecture.
+     * @param filename the file name.
+     */
+    void writeCache(std::string const& filename) const {
+        tdzdd::MessageHandler mh;
+        mh.begin("writing");
+        mh << " \"" << filename << "\" ...";
 
-        while (is) {
-            char c = is.get();
+        std::ofstream fout(filename.c_str(),
+                std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!fout) throw std::runtime_error(strerror(errno));
+        {
+            OutputBuffer out(fout);
+            out.write(cacheMagic(), CACHE_MAGIC_SIZE);
+            putPod(out, cacheSignature());
+            putPod(out, uint64_t(names.size()));
+            for (size_t i = 0; i < names.size(); ++i) {
+                putString(out, names[i]);
+            }
+            putVector(out, edgeNames);
+            putStringMap(out, name2label);
+            putStringMap(out, name2color);
+            putVector(out, name2vertex);
+            putVector(out, vertex2name);
+            putVector(out, edge2name);
+            putVector(out, edgeInfo_);
+            putVector(out, virtualMate_);
+            putVector(out, colorNumber_);
+            putPod(out, vMax);
+            putPod(out, numColor_);
+            putPod(out, char(hasColorPairs_));
+        }
+        if (!fout.flush()) throw std::runtime_error(strerror(errno));
 
-            if (isspace(c)) {
-                if (!v.empty()) {
-                    if (v1.empty()) {
-                        v1 = v;
-                        v.clear();
-                    }
-                    else if (v2.empty()) {
-                        v2 = v;
-                        v.clear();
-                    }
-                    else {
-                        throw std::runtime_error(
-                                "ERROR: More than two tokens in a line");
-                    }
-                }
+        mh.end();
+    }
 
-                if (c == '\n') {
-                    if (!v1.empty() && !v2.empty()) {
-                        edgeNames.push_back(std::make_pair(v1, v2));
-                        v1.clear();
-                        v2.clear();
-                    }
-                    else if (!v1.empty()) {
-                        throw std::runtime_error(
-                                "ERROR: Only one token in a line");
-                    }
-                }
+    /**
+     * Reads a binary cache file written by writeCache.
+     * @param filename the file name.
+     */
+    void readCache(std::string const& filename) {
+        tdzdd::MessageHandler mh;
+        mh.begin("reading");
+        mh << " \"" << filename << "\" ...";
+
+        MappedFile mf(filename);
+        CacheReader in(mf.begin(), mf.end());
+        char magic[CACHE_MAGIC_SIZE];
+        in.get(magic, sizeof(magic));
+        uint64_t signature;
+        in.get(signature);
+        if (std::memcmp(magic, cacheMagic(), CACHE_MAGIC_SIZE) != 0
+                || signature != cacheSignature()) throw std::runtime_error(
+                "ERROR: " + filename + ": Not a graph cache for this machine");
+
+        uint64_t n;
+        in.get(n);
+        names.resize(n);
+        for (size_t i = 0; i < n; ++i) {
+            in.get(names[i]);
+        }
+        in.get(edgeNames);
+        in.get(name2label);
+        in.get(name2color);
+        in.get(name2vertex);
+        in.get(vertex2name);
+        in.get(edge2name);
+        in.get(edgeInfo_, EdgeInfo(0, 0));
+        in.get(virtualMate_);
+        in.get(colorNumber_);
+        in.get(vMax);
+        in.get(numColor_);
+        char c;
+        in.get(c);
+        hasColorPairs_ = c;
+
+        number2name.clear();
+        string2name.initialize(names.size());
+        for (size_t i = 0; i < names.size(); ++i) {
+            int k = decimalValue(names[i].data(), names[i].size());
+            if (k >= 0) {
+                if (size_t(k) >= number2name.size()) number2name.resize(k + 1);
+                number2name[k] = i + 1;
             }
             else {
-                v += c;
+                string2name[names[i]] = i;
             }
         }
 
-        if (!v1.empty() && !v2.empty()) {
-            edgeNames.push_back(std::make_pair(v1, v2));
+        edgeIndex.initialize(edgeInfo_.size());
+        for (size_t a = 0; a < edgeInfo_.size(); ++a) {
+            edgeIndex[edgeKey(edgeInfo_[a].v1, edgeInfo_[a].v2)] = a;
         }
-        else if (!v1.empty()) {
-            throw std::runtime_error("ERROR: Only one token in a line");
+
+        mh.end();
+    }
+
+private:
+    static size_t const CACHE_MAGIC_SIZE = 16;
+
+    static char const* cacheMagic() {
+        return "TdZddGraphCache";
+    }
+
+    static uint64_t cacheSignature() {
+        uint32_t version = 1;
+        return (uint64_t(version) << 48) | (uint64_t(sizeof(EdgeInfo)) << 32)
+                | 0x01020304U;
+    }
+
+    template<typename T>
+    static void putPod(OutputBuffer& out, T const& x) {
+        out.write(reinterpret_cast<char const*>(&x), sizeof(T));
+    }
+
+    template<typename T>
+    static void putVector(OutputBuffer& out, std::vector<T> const& v) {
+        putPod(out, uint64_t(v.size()));
+        if (!v.empty()) {
+            out.write(reinterpret_cast<char const*>(&v[0]),
+                    v.size() * sizeof(T));
+        }
+    }
+
+    static void putString(OutputBuffer& out, std::string const& s) {
+        putPod(out, uint64_t(s.size()));
+        out.write(s.data(), s.size());
+    }
+
+    static void putStringMap(OutputBuffer& out,
+            std::map<std::string,std::string> const& m) {
+        putPod(out, uint64_t(m.size()));
+        for (std::map<std::string,std::string>::const_iterator t = m.begin();
+                t != m.end(); ++t) {
+            putString(out, t->first);
+            putString(out, t->second);
         }
     }
 
-    void readAdjacencyList(std::istream& is) {
+    class CacheReader {
+        char const* p;
+        char const* const end;
+
+        char const* take(uint64_t n) {
+            if (uint64_t(end - p) < n) throw std::runtime_error(
+                    "ERROR: Broken graph cache");
+            char const* q = p;
+            p += n;
+            return q;
+        }
+
+    public:
+        CacheReader(char const* begin, char const* end)
+                : p(begin), end(end) {
+        }
+
+        void get(void* x, size_t n) {
+            std::memcpy(x, take(n), n);
+        }
+
+        template<typename T>
+        void get(T& x) {
+            get(static_cast<void*>(&x), sizeof(T));
+        }
+
+        template<typename T>
+        void get(std::vector<T>& v, T const& init = T()) {
+            uint64_t n;
+            get(n);
+            if (n > uint64_t(end - p) / sizeof(T)) throw std::runtime_error(
+                    "ERROR: Broken graph cache");
+            v.assign(n, init);
+            if (n > 0) get(static_cast<void*>(&v[0]), n * sizeof(T));
+        }
+
+        void get(std::string& s) {
+            uint64_t n;
+            get(n);
+            s.assign(take(n), n);
+        }
+
+        void get(std::map<std::string,std::string>& m) {
+            uint64_t n;
+            get(n);
+            m.clear();
+            for (uint64_t i = 0; i < n; ++i) {
+                std::string k;
+                get(k);
+                get(m[k]);
+            }
+        }
+    };
+
+    static bool isSpace(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    void readEdges(char const* p, char const* e) {
+        NameNumber v[2];
+        int k = 0;
+
+        while (true) {
+            if (p == e || *p == '\n') {
+                if (k == 2) {
+                    edgeNames.push_back(std::make_pair(v[0], v[1]));
+                }
+                else if (k == 1) {
+                    throw std::runtime_error("ERROR: Only one token in a line");
+                }
+                k = 0;
+                if (p == e) break;
+                ++p;
+            }
+            else if (isSpace(*p)) {
+                ++p;
+            }
+            else {
+                char const* q = p;
+                while (q < e && !isSpace(*q)) {
+                    ++q;
+                }
+                if (k == 2) throw std::runtime_error(
+                        "ERROR: More than two tokens in a line");
+                v[k++] = internName(p, q - p);
+                p = q;
+            }
+        }
+    }
+
+    void readAdjacencyList(char const* p, char const* e) {
         edgeNames.clear();
         name2label.clear();
         name2color.clear();
 
         VertexNumber v1 = 1;
-        VertexNumber v2;
+        NameNumber x1 = -1;
 
-        while (is) {
-            char c;
-            while (isspace(c = is.get())) {
-                if (c == '\n') ++v1;
+        while (p < e) {
+            if (isSpace(*p)) {
+                if (*p == '\n') {
+                    ++v1;
+                    x1 = -1;
+                }
+                ++p;
+                continue;
+            }
+
+            bool negative = (*p == '-');
+            if (*p == '-' || *p == '+') ++p;
+            if (p == e || unsigned(*p - '0') > 9) throw std::runtime_error(
+                    "ERROR: Vertex number expected");
+            int v2 = 0;
+            while (p < e && unsigned(*p - '0') <= 9) {
+                v2 = v2 * 10 + (*p++ - '0');
             }
-            if (!is) break;
-            is.unget();
-            is >> v2;
 
-            edgeNames.push_back(std::make_pair(to_string(v1), to_string(v2)));
+            if (x1 < 0) x1 = internNumber(v1);
+            NameNumber x2 = internNumber(negative ? -v2 : v2);
+            edgeNames.push_back(std::make_pair(x1, x2));
         }
     }
 
@@ -280,51 +563,51 @@ public:
      *   name2color
      */
     void update() {
-        name2vertex.clear();
-        vertex2name.clear();
-        name2edge.clear();
+        name2vertex.assign(names.size(), 0);
+        vertex2name.assign(1, -1); // begin vertex number with 1
         edge2name.clear();
         edgeInfo_.clear();
-        edgeIndex.clear();
+        edgeIndex.initialize(edgeNames.size());
         vMax = 0;
 
         // Make unique edge name list
-        for (size_t i = 0; i < edgeNames.size(); ++i) {
-            std::pair<std::string,std::string> const& e = edgeNames[i];
-
-            if (name2edge.count(e) == 0) {
-                edge2name.push_back(e);
-                name2edge[e] = -1;
-                name2edge[std::make_pair(e.second, e.first)] = -1;
+        {
+            MyHashTable<uint64_t> seen(edgeNames.size());
+
+            for (size_t i = 0; i < edgeNames.size(); ++i) {
+                NameNumberPair const& e = edgeNames[i];
+                NameNumber x1 = std::min(e.first, e.second);
+                NameNumber x2 = std::max(e.first, e.second);
+                size_t n = seen.size();
+                seen.add(edgeKey(x1 + 1, x2 + 1));
+                if (seen.size() > n) edge2name.push_back(e);
             }
         }
 
         // Sort vertices by leaving order
         {
-            std::vector<std::string> stack;
+            std::vector<NameNumber> stack;
             stack.reserve(edge2name.size() * 2);
 
             for (size_t i = edge2name.size() - 1; i + 1 > 0; --i) {
-                std::string const& s1 = edge2name[i].first;
-                std::string const& s2 = edge2name[i].second;
+                NameNumber x1 = edge2name[i].first;
+                NameNumber x2 = edge2name[i].second;
 
-                if (name2vertex.count(s2) == 0) {
-                    name2vertex[s2] = 0;
-                    stack.push_back(s2);
+                if (name2vertex[x2] == 0) {
+                    name2vertex[x2] = -1;
+                    stack.push_back(x2);
                 }
 
-                if (name2vertex.count(s1) == 0) {
-                    name2vertex[s1] = 0;
-                    stack.push_back(s1);
+                if (name2vertex[x1] == 0) {
+                    name2vertex[x1] = -1;
+                    stack.push_back(x1);
                 }
             }
 
-            vertex2name.push_back(""); // begin vertex number with 1
-
             while (!stack.empty()) {
-                std::string const& s = stack.back();
-                name2vertex[s] = vertex2name.size();
-                vertex2name.push_back(s);
+                NameNumber x = stack.back();
+                name2vertex[x] = vertex2name.size();
+                vertex2name.push_back(x);
                 if (vertex2name.size() > size_t(MAX_VERTICES)) throw std::runtime_error(
                         "ERROR: Vertex number > " + to_string(MAX_VERTICES));
                 stack.pop_back();
@@ -332,32 +615,15 @@ public:
         }
 
         for (size_t i = 0; i < edge2name.size(); ++i) {
-            std::pair<std::string,std::string> const& e = edge2name[i];
-            std::string s1 = e.first;
-            std::string s2 = e.second;
-
-            if (name2vertex[s1] > name2vertex[s2]) {
-                std::swap(s1, s2);
-            }
-
-            VertexNumber v1 = name2vertex[s1];
-            VertexNumber v2 = name2vertex[s2];
+            VertexNumber v1 = name2vertex[edge2name[i].first];
+            VertexNumber v2 = name2vertex[edge2name[i].second];
+            if (v1 > v2) std::swap(v1, v2);
+            assert(v1 > 0);
 
-            if (v1 == 0) throw std::runtime_error(
-                    "ERROR: " + s1 + ": No such vertex");
-            if (v2 == 0) throw std::runtime_error(
-                    "ERROR: " + s2 + ": No such vertex");
-
-            VertexNumberPair vp(v1, v2);
-
-            if (edgeIndex.count(vp) == 0) {
-                EdgeNumber a = edgeInfo_.size();
-                edgeInfo_.push_back(EdgeInfo(v1, v2));
-                edgeIndex[vp] = a;
-                name2edge[std::make_pair(s1, s2)] = a;
-                name2edge[std::make_pair(s2, s1)] = a;
-                if (vMax < v2) vMax = v2;
-            }
+            EdgeNumber& a = edgeIndex[edgeKey(v1, v2)];
+            a = edgeInfo_.size();
+            edgeInfo_.push_back(EdgeInfo(v1, v2));
+            if (vMax < v2) vMax = v2;
 
             if (edgeInfo_.size() > size_t(MAX_EDGES)) throw std::runtime_error(
                     "ERROR: Edge number > " + to_string(MAX_EDGES));
@@ -368,7 +634,7 @@ public:
 
             for (std::map<std::string,std::string>::iterator t =
                     name2color.begin(); t != name2color.end(); ++t) {
-                VertexNumber v = name2vertex[t->first];
+                VertexNumber v = findVertex(t->first);
                 if (v == 0) throw std::runtime_error(
                         "ERROR: " + t->first + ": No such vertex");
                 color2vertices[t->second].insert(v); // color => set of vertices
@@ -483,6 +749,28 @@ public:
         }
     }
 
+    /**
+     * Rearranges the edges and renumbers the vertices accordingly.
+     * Edge names, labels and colors are kept.
+     * @param order the current edge numbers in the new order.
+     */
+    void reorderEdges(std::vector<EdgeNumber> const& order) {
+        if (order.size() != edge2name.size()) throw std::runtime_error(
+                "ERROR: Edge order size mismatch");
+        std::vector<bool> used(order.size());
+        std::vector<NameNumberPair> tmp;
+        tmp.reserve(order.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            EdgeNumber a = order[i];
+            if (a < 0 || edgeSize() <= a || used[a]) throw std::runtime_error(
+                    "ERROR: Edge order is not a permutation");
+            used[a] = true;
+            tmp.push_back(edge2name[a]);
+        }
+        edgeNames.swap(tmp);
+        update();
+    }
+
     VertexNumber vertexSize() const {
         return vMax;
     }
@@ -498,16 +786,15 @@ public:
     }
 
     VertexNumber getVertex(std::string const& name) const {
-        std::map<std::string,VertexNumber>::const_iterator found =
-                name2vertex.find(name);
-        if (found == name2vertex.end()) throw std::runtime_error(
+        VertexNumber v = findVertex(name);
+        if (v == 0) throw std::runtime_error(
                 "ERROR: " + name + ": No such vertex");
-        return found->second;
+        return v;
     }
 
     std::string vertexName(VertexNumber v) const {
         if (v < 1 || vertexSize() < v) return "?";
-        return vertex2name[v];
+        return names[vertex2name[v]];
     }
 
     std::string vertexLabel(VertexNumber v) const {
@@ -523,11 +810,13 @@ public:
     }
 
     EdgeNumber getEdge(std::pair<std::string,std::string> const& name) const {
-        std::map<std::pair<std::string,std::string>,EdgeNumber>::const_iterator found =
-                name2edge.find(name);
-        if (found == name2edge.end()) throw std::runtime_error(
+        VertexNumber v1 = findVertex(name.first);
+        VertexNumber v2 = findVertex(name.second);
+        if (v1 > v2) std::swap(v1, v2);
+        EdgeNumber const* found = v1 ? edgeIndex.getValue(edgeKey(v1, v2)) : 0;
+        if (found == 0) throw std::runtime_error(
                 "ERROR: " + name.first + "," + name.second + ": No such edge");
-        return found->second;
+        return *found;
     }
 
     EdgeNumber getEdge(std::string const& name1,
@@ -537,7 +826,8 @@ public:
 
     std::pair<std::string,std::string> edgeName(EdgeNumber e) const {
         if (e < 0 || edgeSize() <= e) return std::make_pair("?", "?");
-        return edge2name[e];
+        return std::make_pair(names[edge2name[e].first],
+                names[edge2name[e].second]);
     }
 
     std::string edgeLabel(EdgeNumber e) const {
@@ -561,13 +851,11 @@ public:
         assert(1 <= v1 && v1 <= vMax);
         assert(1 <= v2 && v2 <= vMax);
         if (v1 > v2) std::swap(v1, v2);
-        VertexNumberPair vp(v1, v2);
-        std::map<VertexNumberPair,EdgeNumber>::const_iterator found =
-                edgeIndex.find(vp);
-        if (found == edgeIndex.end()) throw std::runtime_error(
+        EdgeNumber const* found = edgeIndex.getValue(edgeKey(v1, v2));
+        if (found == 0) throw std::runtime_error(
                 "ERROR: (" + to_string(v1) + "," + to_string(v2)
                         + "): No such edge");
-        return found->second;
+        return *found;
     }
 
     VertexNumber maxFrontierSize() const {
@@ -613,9 +901,8 @@ public:
         os << "graph {\n";
         //os << "  layout=neato;\n";
 
-        for (std::vector<std::string>::const_iterator t = vertex2name.begin();
-                t != vertex2name.end(); ++t) {
-            if (t->empty()) continue;
+        for (size_t v = 1; v < vertex2name.size(); ++v) {
+            std::string const* t = &names[vertex2name[v]];
             os << "  \"" << *t << "\"";
             std::map<std::string,std::string>::const_iterator e =
                     name2label.find(*t);
@@ -631,8 +918,8 @@ public:
 
         for (EdgeNumber a = 0; a < edgeSize(); ++a) {
             EdgeInfo const& e = edgeInfo(a);
-            std::string s1 = vertex2name[e.v1];
-            std::string s2 = vertex2name[e.v2];
+            std::string const& s1 = names[vertex2name[e.v1]];
+            std::string const& s2 = names[vertex2name[e.v2]];
             os << "  \"" << s1 << "\"--\"" << s2 << "\"";
             std::map<std::string,std::string>::const_iterator t =
                     name2label.find(s1 + "," + s2);
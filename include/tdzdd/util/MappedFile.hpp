@@ -0,0 +1,141 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tdzdd {
+
+/**
+ * Read-only view of a whole input file.
+ * A regular file is memory-mapped; standard input, pipes and
+ * platforms without mmap(2) fall back to reading into a buffer.
+ */
+class MappedFile {
+    char const* data_;
+    size_t size_;
+    bool mapped;
+    std::string buffer;
+
+    MappedFile(MappedFile const&);
+    MappedFile& operator=(MappedFile const&);
+
+    void readAll(std::istream& is) {
+        char tmp[1 << 16];
+        while (is.read(tmp, sizeof(tmp)), is.gcount() > 0) {
+            buffer.append(tmp, is.gcount());
+        }
+        data_ = buffer.data();
+        size_ = buffer.size();
+    }
+
+public:
+    /**
+     * Constructor.
+     * @param filename the file name or an empty string for STDIN.
+     */
+    MappedFile(std::string const& filename = "") :
+            data_(0), size_(0), mapped(false) {
+        if (filename.empty()) {
+            readAll(std::cin);
+            return;
+        }
+
+#ifndef _WIN32
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error(strerror(errno));
+
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            void* p = ::mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                ::madvise(p, st.st_size, MADV_SEQUENTIAL);
+                data_ = static_cast<char const*>(p);
+                size_ = st.st_size;
+                mapped = true;
+            }
+        }
+        ::close(fd);
+        if (mapped) return;
+#endif
+
+        std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+        if (!fin) throw std::runtime_error(strerror(errno));
+        readAll(fin);
+    }
+
+    ~MappedFile() {
+#ifndef _WIN32
+        if (mapped) ::munmap(const_cast<char*>(data_), size_);
+#endif
+    }
+
+    /**
+     * Gets the first byte of the contents.
+     * @return pointer to the contents.
+     */
+    char const* begin() const {
+        return data_;
+    }
+
+    /**
+     * Gets the end of the contents.
+     * @return pointer to the position after the last byte.
+     */
+    char const* end() const {
+        return data_ + size_;
+    }
+
+    /**
+     * Gets the size of the contents.
+     * @return the size in bytes.
+     */
+    size_t size() const {
+        return size_;
+    }
+
+    /**
+     * Checks if the contents are memory-mapped.
+     * @return true if memory-mapped.
+     */
+    bool isMapped() const {
+        return mapped;
+    }
+};
+
+} // namespace tdzdd
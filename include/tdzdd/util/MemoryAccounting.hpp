@@ -0,0 +1,203 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iomanip>
+#include <ostream>
+#include <stdint.h>
+
+namespace tdzdd {
+
+/**
+ * Opt-in accounting of the memory allocated by the library containers.
+ * The bytes are tagged by the subsystem that owns them, which is told by
+ * the container: the builders keep pending spec states in MyList blocks,
+ * the subsetters keep them in MemoryPool blocks, the node tables keep
+ * their rows in MyVector<Node>, and the unique tables are MyHashTable.
+ * MyList and MemoryPool blocks remember whether they have been counted,
+ * so they can be released after accounting is stopped or started.
+ * MyVector arrays and MyHashTable storage are charged by their sizes
+ * when they are released, so accounting should be enabled before those
+ * to be measured are created.
+ * The per-level breakdown is recorded by Telemetry.
+ */
+class MemoryAccounting {
+public:
+    enum Kind {
+        LIST,     ///< Pending spec states of the builders in MyList blocks.
+        POOL,     ///< Spec states of the subsetters in MemoryPool blocks.
+        VECTOR,   ///< Other MyVector arrays such as per-level work tables.
+        HASH,     ///< Unique tables and other MyHashTable storage.
+        ROWS,     ///< Rows of the node tables.
+        NUM_KINDS
+    };
+
+    /**
+     * Kind of the MyVector arrays of an element type.
+     * It is specialized for the element types of particular subsystems.
+     * @tparam T the element type.
+     */
+    template<typename T>
+    struct VectorKind {
+        static Kind const value = VECTOR;
+    };
+
+    /**
+     * Counters of one kind of containers.
+     */
+    struct Counter {
+        int64_t live;   ///< Bytes currently allocated.
+        int64_t peak;   ///< Maximum of the live bytes since the last reset.
+        uint64_t total; ///< Bytes allocated since the last reset.
+    };
+
+private:
+    static bool& flag() {
+        static bool f = false;
+        return f;
+    }
+
+    static Counter* counters() {
+        static Counter c[NUM_KINDS];
+        return c;
+    }
+
+public:
+    /**
+     * Starts or stops accounting.
+     * @param on true to start accounting.
+     */
+    static void enable(bool on = true) {
+        flag() = on;
+    }
+
+    /**
+     * Checks if accounting is active.
+     * @return true if accounting is active.
+     */
+    static bool enabled() {
+        return flag();
+    }
+
+    /**
+     * Clears the peak and the total of all kinds.
+     */
+    static void reset() {
+        for (int k = 0; k < NUM_KINDS; ++k) {
+            Counter& c = counters()[k];
+            c.peak = c.live;
+            c.total = 0;
+        }
+    }
+
+    /**
+     * Gets the name of a kind.
+     * @param k the kind.
+     * @return the name.
+     */
+    static char const* name(Kind k) {
+        static char const* names[] = {"list", "pool", "vector", "hash",
+                                      "rows"};
+        return names[k];
+    }
+
+    /**
+     * Gets the counters of a kind.
+     * @param k the kind.
+     * @return a copy of the counters.
+     */
+    static Counter get(Kind k) {
+        Counter c;
+#ifdef _OPENMP
+#pragma omp critical(tdzdd_MemoryAccounting)
+#endif
+        c = counters()[k];
+        return c;
+    }
+
+    /**
+     * Records an allocation.
+     * @param k the kind of the container.
+     * @param bytes the size of the allocated memory.
+     * @return true if it is recorded.
+     */
+    static bool allocate(Kind k, size_t bytes) {
+        if (!flag()) return false;
+#ifdef _OPENMP
+#pragma omp critical(tdzdd_MemoryAccounting)
+#endif
+        {
+            Counter& c = counters()[k];
+            c.live += bytes;
+            c.total += bytes;
+            if (c.peak < c.live) c.peak = c.live;
+        }
+        return true;
+    }
+
+    /**
+     * Records a deallocation if accounting is active.
+     * @param k the kind of the container.
+     * @param bytes the size of the released memory.
+     */
+    static void deallocate(Kind k, size_t bytes) {
+        if (!flag()) return;
+        release(k, bytes);
+    }
+
+    /**
+     * Records a deallocation of memory whose allocation has been recorded,
+     * whether accounting is active or not.
+     * @param k the kind of the container.
+     * @param bytes the size of the released memory.
+     */
+    static void release(Kind k, size_t bytes) {
+#ifdef _OPENMP
+#pragma omp critical(tdzdd_MemoryAccounting)
+#endif
+        counters()[k].live -= bytes;
+    }
+
+    /**
+     * Prints the counters of all kinds.
+     * @param os the output stream.
+     */
+    static void print(std::ostream& os) {
+        os << std::setw(8) << "kind" << std::setw(16) << "live"
+                << std::setw(16) << "peak" << std::setw(16) << "total"
+                << "\n";
+        for (int k = 0; k < NUM_KINDS; ++k) {
+            Counter c = get(Kind(k));
+            os << std::setw(8) << name(Kind(k)) << std::setw(16) << c.live
+                    << std::setw(16) << c.peak << std::setw(16) << c.total
+                    << "\n";
+        }
+    }
+};
+
+template<typename T>
+MemoryAccounting::Kind const MemoryAccounting::VectorKind<T>::value;
+
+} // namespace tdzdd
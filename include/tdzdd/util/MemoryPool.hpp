@@ -28,6 +28,7 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "MemoryAccounting.hpp"
 #include "MyVector.hpp"
 
 namespace tdzdd {
@@ -45,9 +46,28 @@ class MemoryPool {
     static size_t const BLOCK_UNITS = 400000 / UNIT_SIZE;
     static size_t const MAX_ELEMENT_UNIS = BLOCK_UNITS / 10;
 
+    /* The first unit of a block links the next block and the second one
+     * holds the size of the block if it is accounted, or 0 otherwise. */
+    static size_t const HEADER_UNITS = 2;
+
     Unit* blockList;
     size_t nextUnit;
 
+    static Unit* newBlock(size_t m) {
+        Unit* block = new Unit[m];
+        bool counted = MemoryAccounting::allocate(MemoryAccounting::POOL,
+                                                  m * UNIT_SIZE);
+        block[1].next = reinterpret_cast<Unit*>(counted ? m : 0);
+        return block;
+    }
+
+    static void deleteBlock(Unit* block) {
+        size_t const m = reinterpret_cast<size_t>(block[1].next);
+        if (m != 0) MemoryAccounting::release(MemoryAccounting::POOL,
+                                              m * UNIT_SIZE);
+        delete[] block;
+    }
+
 public:
     MemoryPool()
             : blockList(0), nextUnit(BLOCK_UNITS) {
@@ -95,7 +115,7 @@ public:
         while (blockList != 0) {
             Unit* block = blockList;
             blockList = blockList->next;
-            delete[] block;
+            deleteBlock(block);
         }
         nextUnit = BLOCK_UNITS;
     }
@@ -105,9 +125,9 @@ public:
         while (blockList->next != 0) {
             Unit* block = blockList;
             blockList = blockList->next;
-            delete[] block;
+            deleteBlock(block);
         }
-        nextUnit = 1;
+        nextUnit = HEADER_UNITS;
     }
 
     void splice(MemoryPool& o) {
@@ -130,8 +150,8 @@ public:
         size_t const elementUnits = (n + UNIT_SIZE - 1) / UNIT_SIZE;
 
         if (elementUnits > MAX_ELEMENT_UNIS) {
-            size_t m = elementUnits + 1;
-            Unit* block = new Unit[m];
+            size_t m = elementUnits + HEADER_UNITS;
+            Unit* block = newBlock(m);
             if (blockList == 0) {
                 block->next = 0;
                 blockList = block;
@@ -140,14 +160,14 @@ public:
                 block->next = blockList->next;
                 blockList->next = block;
             }
-            return block + 1;
+            return block + HEADER_UNITS;
         }
 
         if (nextUnit + elementUnits > BLOCK_UNITS) {
-            Unit* block = new Unit[BLOCK_UNITS];
+            Unit* block = newBlock(BLOCK_UNITS);
             block->next = blockList;
             blockList = block;
-            nextUnit = 1;
+            nextUnit = HEADER_UNITS;
             assert(nextUnit + elementUnits <= BLOCK_UNITS);
         }
 
@@ -28,6 +28,8 @@
 #include <ostream>
 #include <stdint.h>
 
+#include "MemoryAccounting.hpp"
+
 namespace tdzdd {
 
 class MyHashConstant {
@@ -158,6 +160,17 @@ protected:
     Entry* table;          ///< Pointer to the storage.
     size_t collisions_;
 
+    static Entry* newTable(size_t n) {
+        MemoryAccounting::allocate(MemoryAccounting::HASH, n * sizeof(Entry));
+        return new Entry[n]();
+    }
+
+    static void deleteTable(Entry* p, size_t n) {
+        if (p == 0) return;
+        MemoryAccounting::deallocate(MemoryAccounting::HASH, n * sizeof(Entry));
+        delete[] p;
+    }
+
 public:
     /**
      * Default constructor.
@@ -245,7 +258,7 @@ public:
 //    }
 
     void moveAssign(MyHashTable& o) {
-        delete[] table;
+        deleteTable(table, tableCapacity_);
         tableCapacity_ = o.tableCapacity_;
         tableSize_ = o.tableSize_;
         maxSize_ = o.maxSize_;
@@ -257,7 +270,7 @@ public:
     }
 
     virtual ~MyHashTable() {
-        delete[] table;
+        deleteTable(table, tableCapacity_);
     }
 
     size_t tableCapacity() const {
@@ -285,7 +298,7 @@ public:
      * The memory is deallocated.
      */
     void clear() {
-        delete[] table;
+        deleteTable(table, tableCapacity_);
         tableCapacity_ = 0;
         tableSize_ = 0;
         maxSize_ = 0;
@@ -310,9 +323,9 @@ public:
             }
         }
         else {
+            deleteTable(table, tableCapacity_);
             tableCapacity_ = tableSize_;
-            delete[] table;
-            table = new Entry[tableCapacity_]();
+            table = newTable(tableCapacity_);
         }
     }
 
@@ -28,11 +28,13 @@
 #include <cstring>
 #include <stdexcept>
 
+#include "MemoryAccounting.hpp"
+
 namespace tdzdd {
 
 template<typename T, size_t BLOCK_ELEMENTS = 1000>
 class MyList {
-    static int const headerCells = 1;
+    static int const headerCells = 2;
 
     struct Cell {
         Cell* next;
@@ -66,6 +68,24 @@ class MyList {
         return reinterpret_cast<T*>(p + 1);
     }
 
+    /* The first cell of a block holds its size if it is accounted,
+     * or 0 otherwise. */
+    static Cell* newBlock(size_t m) {
+        Cell* block = new Cell[m];
+        bool counted = MemoryAccounting::allocate(MemoryAccounting::LIST,
+                                                  m * sizeof(Cell));
+        block->next = reinterpret_cast<Cell*>(counted ? m : 0);
+        return block;
+    }
+
+    static void deleteBlock(Cell* block) {
+        size_t const m = reinterpret_cast<size_t>(block->next);
+        if (m != 0) {
+            MemoryAccounting::release(MemoryAccounting::LIST, m * sizeof(Cell));
+        }
+        delete[] block;
+    }
+
 public:
     MyList()
             : front_(0), size_(0) {
@@ -127,7 +147,7 @@ public:
                 p = p->next;
             }
 
-            delete[] blockStart(front_);
+            deleteBlock(blockStart(front_));
             front_ = clearFlag(p);
         }
         size_ = 0;
@@ -161,9 +181,9 @@ public:
 
         if (front_ == 0 || front_ < blockStart(front_) + headerCells + n) {
             size_t const m = headerCells + n * BLOCK_ELEMENTS;
-            Cell* newBlock = new Cell[m];
-            Cell* newFront = newBlock + m - n;
-            blockStart(newFront) = newBlock;
+            Cell* block = newBlock(m);
+            Cell* newFront = block + m - n;
+            blockStart(newFront) = block;
             newFront->next = setFlag(front_);
             front_ = newFront;
         }
@@ -186,7 +206,7 @@ public:
         Cell* next = front_->next;
 
         if (flagged(next)) {
-            delete[] blockStart(front_);
+            deleteBlock(blockStart(front_));
             front_ = clearFlag(next);
         }
         else {
@@ -28,6 +28,8 @@
 #include <cstring>
 #include <vector>
 
+#include "MemoryAccounting.hpp"
+
 namespace tdzdd {
 
 template<typename T, typename Size = size_t>
@@ -37,10 +39,14 @@ class MyVector {
     T* array_;         ///< Start address of the array.
 
     static T* allocate(Size n) {
+        MemoryAccounting::allocate(MemoryAccounting::VectorKind<T>::value,
+                                   n * sizeof(T));
         return std::allocator<T>().allocate(n);
     }
 
     static void deallocate(T* p, Size n) {
+        MemoryAccounting::deallocate(MemoryAccounting::VectorKind<T>::value,
+                                     n * sizeof(T));
         std::allocator<T>().deallocate(p, n);
     }
 
@@ -0,0 +1,268 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace tdzdd {
+
+/**
+ * Buffered text writer with hand-rolled integer formatting.
+ * The output goes to a stream, a file descriptor or a string
+ * in large blocks.
+ */
+class OutputBuffer {
+    enum Sink {
+        STREAM, FILE_DESCRIPTOR, STRING
+    };
+
+    Sink const sink;
+    std::ostream* const os;
+    int const fd;
+    std::string* const str;
+    size_t const capacity;
+    char* const buf;
+    size_t pos;
+
+    OutputBuffer(OutputBuffer const&);
+    OutputBuffer& operator=(OutputBuffer const&);
+
+    void flushBuffer() {
+        switch (sink) {
+        case STREAM:
+            os->write(buf, pos);
+            break;
+        case FILE_DESCRIPTOR:
+            for (size_t k = 0; k < pos;) {
+                long w = ::write(fd, buf + k, pos - k);
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::runtime_error(strerror(errno));
+                }
+                k += w;
+            }
+            break;
+        case STRING:
+            str->append(buf, pos);
+            break;
+        }
+        pos = 0;
+    }
+
+    char* reserve(size_t n) {
+        if (pos + n > capacity) flushBuffer();
+        return buf + pos;
+    }
+
+public:
+    static size_t const DEFAULT_CAPACITY = 1 << 20;
+
+    /**
+     * Constructor for a stream.
+     * @param os the output stream.
+     * @param capacity the buffer size in bytes.
+     */
+    explicit OutputBuffer(std::ostream& os,
+            size_t capacity = DEFAULT_CAPACITY) :
+            sink(STREAM), os(&os), fd(-1), str(0), capacity(capacity),
+            buf(new char[capacity]), pos(0) {
+    }
+
+    /**
+     * Constructor for a file descriptor.
+     * The descriptor is not closed by this object.
+     * @param fd the file descriptor.
+     * @param capacity the buffer size in bytes.
+     */
+    explicit OutputBuffer(int fd, size_t capacity = DEFAULT_CAPACITY) :
+            sink(FILE_DESCRIPTOR), os(0), fd(fd), str(0), capacity(capacity),
+            buf(new char[capacity]), pos(0) {
+    }
+
+    /**
+     * Constructor for a string.
+     * The output is appended to the string.
+     * @param str the string.
+     * @param capacity the buffer size in bytes.
+     */
+    explicit OutputBuffer(std::string& str,
+            size_t capacity = DEFAULT_CAPACITY) :
+            sink(STRING), os(0), fd(-1), str(&str), capacity(capacity),
+            buf(new char[capacity]), pos(0) {
+    }
+
+    ~OutputBuffer() {
+        try {
+            flushBuffer();
+        }
+        catch (...) {
+        }
+        delete[] buf;
+    }
+
+    /**
+     * Writes the buffered data to the destination.
+     */
+    void flush() {
+        flushBuffer();
+        if (sink == STREAM) os->flush();
+    }
+
+    /**
+     * Writes a byte sequence.
+     * @param s pointer to the bytes.
+     * @param n the number of bytes.
+     */
+    void write(char const* s, size_t n) {
+        if (n > capacity) {
+            flushBuffer();
+            switch (sink) {
+            case STREAM:
+                os->write(s, n);
+                return;
+            case STRING:
+                str->append(s, n);
+                return;
+            default:
+                break;
+            }
+            while (n > capacity) {
+                std::memcpy(buf, s, capacity);
+                pos = capacity;
+                flushBuffer();
+                s += capacity;
+                n -= capacity;
+            }
+        }
+        std::memcpy(reserve(n), s, n);
+        pos += n;
+    }
+
+    OutputBuffer& operator<<(char c) {
+        *reserve(1) = c;
+        ++pos;
+        return *this;
+    }
+
+    OutputBuffer& operator<<(char const* s) {
+        write(s, std::strlen(s));
+        return *this;
+    }
+
+    OutputBuffer& operator<<(std::string const& s) {
+        write(s.data(), s.size());
+        return *this;
+    }
+
+    /**
+     * Writes an unsigned integer in decimal.
+     * @param v the value.
+     * @return this object.
+     */
+    OutputBuffer& putUnsigned(uint64_t v) {
+        static char const digits[] = "00010203040506070809"
+                "10111213141516171819"
+                "20212223242526272829"
+                "30313233343536373839"
+                "40414243444546474849"
+                "50515253545556575859"
+                "60616263646566676869"
+                "70717273747576777879"
+                "80818283848586878889"
+                "90919293949596979899";
+        char tmp[20];
+        char* p = tmp + sizeof(tmp);
+
+        while (v >= 100) {
+            int k = (v % 100) * 2;
+            v /= 100;
+            *--p = digits[k + 1];
+            *--p = digits[k];
+        }
+        if (v >= 10) {
+            int k = v * 2;
+            *--p = digits[k + 1];
+            *--p = digits[k];
+        }
+        else {
+            *--p = char('0' + v);
+        }
+
+        size_t n = tmp + sizeof(tmp) - p;
+        std::memcpy(reserve(n), p, n);
+        pos += n;
+        return *this;
+    }
+
+    /**
+     * Writes a signed integer in decimal.
+     * @param v the value.
+     * @return this object.
+     */
+    OutputBuffer& putSigned(int64_t v) {
+        if (v < 0) {
+            *this << '-';
+            return putUnsigned(uint64_t(0) - uint64_t(v));
+        }
+        return putUnsigned(v);
+    }
+
+    OutputBuffer& operator<<(int v) {
+        return putSigned(v);
+    }
+
+    OutputBuffer& operator<<(long v) {
+        return putSigned(v);
+    }
+
+    OutputBuffer& operator<<(long long v) {
+        return putSigned(v);
+    }
+
+    OutputBuffer& operator<<(unsigned v) {
+        return putUnsigned(v);
+    }
+
+    OutputBuffer& operator<<(unsigned long v) {
+        return putUnsigned(v);
+    }
+
+    OutputBuffer& operator<<(unsigned long long v) {
+        return putUnsigned(v);
+    }
+};
+
+} // namespace tdzdd
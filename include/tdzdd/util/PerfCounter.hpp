@@ -0,0 +1,403 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "ResourceUsage.hpp"
+
+namespace tdzdd {
+
+/**
+ * Hardware event counts.
+ * A negative count means that the event is not available.
+ */
+struct PerfCounts {
+    enum Event {
+        CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, NUM_EVENTS
+    };
+
+    int64_t count[NUM_EVENTS];
+
+    PerfCounts() {
+        for (int k = 0; k < NUM_EVENTS; ++k) {
+            count[k] = -1;
+        }
+    }
+
+    /**
+     * Gets the name of an event.
+     * @param k the event.
+     * @return the name.
+     */
+    static char const* name(int k) {
+        static char const* names[] = {"cycles", "instructions",
+                                      "cache-misses", "branch-misses"};
+        return names[k];
+    }
+
+    PerfCounts operator-(PerfCounts const& o) const {
+        PerfCounts d;
+        for (int k = 0; k < NUM_EVENTS; ++k) {
+            if (count[k] >= 0 && o.count[k] >= 0) {
+                d.count[k] = count[k] - o.count[k];
+            }
+        }
+        return d;
+    }
+
+    PerfCounts& operator+=(PerfCounts const& o) {
+        for (int k = 0; k < NUM_EVENTS; ++k) {
+            if (o.count[k] < 0) continue;
+            count[k] = (count[k] < 0) ? o.count[k] : count[k] + o.count[k];
+        }
+        return *this;
+    }
+
+    /**
+     * Gets the instructions per cycle.
+     * @return the IPC or a negative value if it is not available.
+     */
+    double ipc() const {
+        if (count[CYCLES] <= 0 || count[INSTRUCTIONS] < 0) return -1;
+        return double(count[INSTRUCTIONS]) / count[CYCLES];
+    }
+};
+
+/**
+ * Hardware counters of the calling thread using perf_event_open(2).
+ * The counters are opened by the thread to be measured.
+ * Events that cannot be opened, because of the platform, the kernel
+ * or the permission, are reported as unavailable.
+ */
+class PerfCounter {
+    int fd[PerfCounts::NUM_EVENTS];
+    bool opened;
+
+    PerfCounter(PerfCounter const&);
+    PerfCounter& operator=(PerfCounter const&);
+
+#ifdef __linux__
+    static int openEvent(int k) {
+        static uint64_t const config[] = {PERF_COUNT_HW_CPU_CYCLES,
+                                          PERF_COUNT_HW_INSTRUCTIONS,
+                                          PERF_COUNT_HW_CACHE_MISSES,
+                                          PERF_COUNT_HW_BRANCH_MISSES};
+        struct perf_event_attr pe;
+        std::memset(&pe, 0, sizeof(pe));
+        pe.type = PERF_TYPE_HARDWARE;
+        pe.size = sizeof(pe);
+        pe.config = config[k];
+        pe.exclude_kernel = 1;
+        pe.exclude_hv = 1;
+        return syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+    }
+#endif
+
+public:
+    PerfCounter() :
+            opened(false) {
+        for (int k = 0; k < PerfCounts::NUM_EVENTS; ++k) {
+            fd[k] = -1;
+        }
+    }
+
+    ~PerfCounter() {
+#ifdef __linux__
+        for (int k = 0; k < PerfCounts::NUM_EVENTS; ++k) {
+            if (fd[k] >= 0) close(fd[k]);
+        }
+#endif
+    }
+
+    /**
+     * Opens the counters for the calling thread if not yet opened.
+     * @return true if at least one event is available.
+     */
+    bool open() {
+        if (!opened) {
+            opened = true;
+#ifdef __linux__
+            for (int k = 0; k < PerfCounts::NUM_EVENTS; ++k) {
+                fd[k] = openEvent(k);
+            }
+#endif
+        }
+        return available();
+    }
+
+    /**
+     * Checks if at least one event is available.
+     * @return true if available.
+     */
+    bool available() const {
+        for (int k = 0; k < PerfCounts::NUM_EVENTS; ++k) {
+            if (fd[k] >= 0) return true;
+        }
+        return false;
+    }
+
+    /**
+     * Reads the current counts.
+     * @return the counts since the counters were opened.
+     */
+    PerfCounts read() const {
+        PerfCounts c;
+#ifdef __linux__
+        for (int k = 0; k < PerfCounts::NUM_EVENTS; ++k) {
+            uint64_t v;
+            if (fd[k] >= 0 && ::read(fd[k], &v, sizeof(v)) == sizeof(v)) {
+                c.count[k] = v;
+            }
+        }
+#endif
+        return c;
+    }
+};
+
+/**
+ * Per-phase and per-level profile of hardware counters.
+ * Nothing is measured until enabled.
+ * The time and the counts of phases run by multiple threads
+ * are summed over the threads.
+ */
+class PerfProfile {
+    struct Record {
+        size_t calls;
+        double time;
+        PerfCounts counts;
+
+        Record() :
+                calls(0), time(0) {
+        }
+    };
+
+    typedef std::map<std::pair<std::string,int>,Record> Table;
+
+    static bool& flag() {
+        static bool f = false;
+        return f;
+    }
+
+    static Table& table() {
+        static Table t;
+        return t;
+    }
+
+    static PerfCounter*& counters() {
+        static PerfCounter* p = 0;
+        return p;
+    }
+
+    static int& numCounters() {
+        static int n = 0;
+        return n;
+    }
+
+public:
+    /**
+     * Starts or stops profiling.
+     * Must not be called in a parallel region.
+     * @param on true to start profiling.
+     */
+    static void enable(bool on = true) {
+        if (on && counters() == 0) {
+#ifdef _OPENMP
+            numCounters() = omp_get_max_threads();
+#else
+            numCounters() = 1;
+#endif
+            counters() = new PerfCounter[numCounters()];
+        }
+        flag() = on;
+    }
+
+    /**
+     * Checks if profiling is active.
+     * @return true if profiling is active.
+     */
+    static bool enabled() {
+        return flag();
+    }
+
+    /**
+     * Checks if hardware counters work on the calling thread.
+     * Only the time is recorded when they do not.
+     * @return true if at least one event is available.
+     */
+    static bool countersAvailable() {
+        return flag() && threadCounter().available();
+    }
+
+    /**
+     * Gets the counters of the calling thread.
+     * @return the counters.
+     */
+    static PerfCounter& threadCounter() {
+#ifdef _OPENMP
+        int y = omp_get_thread_num();
+#else
+        int y = 0;
+#endif
+        if (y >= numCounters()) {
+            static PerfCounter none;
+            return none;
+        }
+        PerfCounter& pc = counters()[y];
+        pc.open();
+        return pc;
+    }
+
+    /**
+     * Clears the profile.
+     */
+    static void clear() {
+        table().clear();
+    }
+
+    /**
+     * Adds a measurement.
+     * @param phase the phase name.
+     * @param level the level.
+     * @param time the elapsed time.
+     * @param counts the event counts.
+     */
+    static void add(std::string const& phase, int level, double time,
+            PerfCounts const& counts) {
+#ifdef _OPENMP
+#pragma omp critical(tdzdd_PerfProfile)
+#endif
+        {
+            Record& r = table()[std::make_pair(phase, level)];
+            ++r.calls;
+            r.time += time;
+            r.counts += counts;
+        }
+    }
+
+    /**
+     * Prints the profile.
+     * Unavailable counts are printed as "-".
+     * @param os the output stream.
+     */
+    static void print(std::ostream& os) {
+        std::ios_base::fmtflags backup = os.flags(std::ios::fixed);
+        std::streamsize prec = os.precision();
+
+        os << std::setw(14) << "phase" << std::setw(6) << "level"
+                << std::setw(7) << "calls" << std::setw(11) << "time";
+        for (int k = 0; k < PerfCounts::NUM_EVENTS; ++k) {
+            os << std::setw(15) << PerfCounts::name(k);
+        }
+        os << std::setw(7) << "IPC" << "\n";
+
+        for (Table::const_iterator t = table().begin(); t != table().end();
+                ++t) {
+            Record const& r = t->second;
+            os << std::setw(14) << t->first.first << std::setw(6)
+                    << t->first.second << std::setw(7) << r.calls
+                    << std::setw(11) << std::setprecision(6) << r.time;
+            for (int k = 0; k < PerfCounts::NUM_EVENTS; ++k) {
+                if (r.counts.count[k] < 0) {
+                    os << std::setw(15) << "-";
+                }
+                else {
+                    os << std::setw(15) << r.counts.count[k];
+                }
+            }
+            double ipc = r.counts.ipc();
+            if (ipc < 0) {
+                os << std::setw(7) << "-";
+            }
+            else {
+                os << std::setw(7) << std::setprecision(2) << ipc;
+            }
+            os << "\n";
+        }
+
+        os.precision(prec);
+        os.flags(backup);
+    }
+};
+
+/**
+ * Measures a phase of the calling thread from the construction
+ * until stop() or the destruction.
+ */
+class PerfScope {
+    char const* const phase;
+    int const level;
+    bool active;
+    double startTime;
+    PerfCounts startCounts;
+
+public:
+    /**
+     * Constructor.
+     * @param phase the phase name.
+     * @param level the level.
+     */
+    PerfScope(char const* phase, int level) :
+            phase(phase), level(level), active(PerfProfile::enabled()),
+            startTime(0) {
+        if (!active) return;
+        startCounts = PerfProfile::threadCounter().read();
+        startTime = getWallClockTime();
+    }
+
+    ~PerfScope() {
+        stop();
+    }
+
+    /**
+     * Ends the measurement.
+     */
+    void stop() {
+        if (!active) return;
+        active = false;
+        double t = getWallClockTime() - startTime;
+        PerfCounts c = PerfProfile::threadCounter().read() - startCounts;
+        PerfProfile::add(phase, level, t, c);
+    }
+};
+
+} // namespace tdzdd
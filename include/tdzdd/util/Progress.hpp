@@ -0,0 +1,181 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include "MemoryAccounting.hpp"
+#include "ResourceUsage.hpp"
+#include "Telemetry.hpp"
+
+namespace tdzdd {
+
+/**
+ * Progress of a DD operation at a level boundary.
+ */
+struct ProgressInfo {
+    char const* op;    ///< "build", "subset", "reduce" or "evaluate".
+    int level;         ///< The level just processed.
+    int levelsDone;    ///< The number of levels processed so far.
+    int numLevels;     ///< The number of levels to be processed.
+    size_t states;     ///< The number of input states or nodes so far.
+    size_t nodes;      ///< The number of output nodes so far.
+    size_t inputDone;  ///< The number of input DD nodes processed so far.
+    size_t inputTotal; ///< The number of input DD nodes or 0 if no input DD.
+    size_t bytes;      ///< Live bytes of MemoryAccounting, or peak RSS.
+
+    /**
+     * Estimates the completed fraction of the operation.
+     * It is based on the input DD nodes if any and on the levels otherwise.
+     * @return the fraction between 0 and 1.
+     */
+    double fraction() const {
+        if (inputTotal > 0) return double(inputDone) / inputTotal;
+        return (numLevels > 0) ? double(levelsDone) / numLevels : 1;
+    }
+};
+
+/**
+ * Interface of progress callbacks.
+ */
+class ProgressCallback {
+public:
+    virtual ~ProgressCallback() {
+    }
+
+    /**
+     * Receives the progress after every level.
+     * @param info the progress.
+     * @return false to cancel the operation.
+     */
+    virtual bool progress(ProgressInfo const& info) = 0;
+};
+
+/**
+ * Exception thrown when an operation is cancelled by the progress callback.
+ */
+class Cancelled: public std::runtime_error {
+public:
+    Cancelled(std::string const& op) :
+            std::runtime_error(op + " cancelled") {
+    }
+};
+
+/**
+ * Progress reporter of a DD operation.
+ * The operation reports to its own callback if any, and otherwise to
+ * the default callback of the calling thread set by setCallback().
+ * Nothing is reported when neither is set.
+ */
+class Progress {
+    static ProgressCallback*& callback() {
+#if __cplusplus >= 201103L
+        static thread_local ProgressCallback* cb = 0;
+#elif defined(_MSC_VER)
+        static __declspec(thread) ProgressCallback* cb = 0;
+#else
+        static __thread ProgressCallback* cb = 0;
+#endif
+        return cb;
+    }
+
+    ProgressCallback* const cb;
+    ProgressInfo info;
+
+public:
+    /**
+     * Sets the default progress callback of the calling thread.
+     * @param cb the callback or null to stop reporting.
+     * @return the previous callback.
+     */
+    static ProgressCallback* setCallback(ProgressCallback* cb) {
+        ProgressCallback* prev = callback();
+        callback() = cb;
+        return prev;
+    }
+
+    /**
+     * Checks if an operation will report its progress.
+     * @param cb the callback of the operation or null.
+     * @return true if a callback is effective.
+     */
+    static bool willReport(ProgressCallback* cb) {
+        return cb != 0 || callback() != 0;
+    }
+
+    /**
+     * Constructor.
+     * @param op the operation.
+     * @param numLevels the number of levels to be processed.
+     * @param inputTotal the number of input DD nodes.
+     * @param cb the callback of the operation or null for the default.
+     */
+    Progress(char const* op, int numLevels, size_t inputTotal = 0,
+            ProgressCallback* cb = 0) :
+            cb(cb ? cb : callback()) {
+        info.op = op;
+        info.level = 0;
+        info.levelsDone = 0;
+        info.numLevels = numLevels;
+        info.states = 0;
+        info.nodes = 0;
+        info.inputDone = 0;
+        info.inputTotal = inputTotal;
+        info.bytes = 0;
+    }
+
+    /**
+     * Reports the progress of one level to the callback.
+     * @param level the level.
+     * @param stats the counters of the level.
+     * @param inputNodes the number of input DD nodes at the level.
+     * @return false if cancellation is requested.
+     */
+    bool report(int level, LevelStats const& stats, size_t inputNodes = 0) {
+        if (cb == 0) return true;
+
+        info.level = level;
+        ++info.levelsDone;
+        info.states += stats.states;
+        info.nodes += stats.nodes;
+        info.inputDone += inputNodes;
+
+        if (MemoryAccounting::enabled()) {
+            int64_t live = 0;
+            for (int k = 0; k < MemoryAccounting::NUM_KINDS; ++k) {
+                live += MemoryAccounting::get(MemoryAccounting::Kind(k)).live;
+            }
+            info.bytes = (live > 0) ? live : 0;
+        }
+        else {
+            info.bytes = ResourceUsage().maxrss * size_t(1024);
+        }
+
+        return cb->progress(info);
+    }
+};
+
+} // namespace tdzdd
@@ -0,0 +1,223 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "demangle.hpp"
+#include "MemoryAccounting.hpp"
+#include "ResourceUsage.hpp"
+
+namespace tdzdd {
+
+/**
+ * Counters of one level of a DD operation.
+ */
+struct LevelStats {
+    size_t states; ///< The number of input states or nodes.
+    size_t unique; ///< The number of them left after deduplication.
+    size_t nodes;  ///< The number of nodes in the output row.
+    size_t dead;   ///< The number of nodes found equivalent to 0-terminal.
+    size_t swept;  ///< The number of nodes removed by sweeping.
+    size_t slots;  ///< The total size of the hash tables.
+    size_t probes; ///< The number of hash collisions.
+
+    LevelStats() {
+        clear();
+    }
+
+    void clear() {
+        states = unique = nodes = dead = swept = slots = probes = 0;
+    }
+};
+
+/**
+ * Machine-readable per-level trace of DD operations.
+ * Nothing is recorded until an output stream is set by setOutput(),
+ * and an operation started before that is not recorded at all.
+ * Each record has the operation, its subject, the level,
+ * the counters in LevelStats, the hash table load factor,
+ * the wall and CPU time in seconds and the growth of the peak RSS
+ * in kilobytes since the previous record.
+ * When MemoryAccounting is enabled, the live bytes of each kind of
+ * containers and the bytes allocated since the previous record follow.
+ */
+class Telemetry {
+public:
+    enum Format {
+        JSON, ///< One JSON object per line.
+        CSV   ///< Comma-separated values with a header line.
+    };
+
+private:
+    static std::ostream*& sink() {
+        static std::ostream* os = 0;
+        return os;
+    }
+
+    static Format& format() {
+        static Format fmt = JSON;
+        return fmt;
+    }
+
+    static int& lastId() {
+        static int id = 0;
+        return id;
+    }
+
+    char const* const op;
+    std::string const name;
+    int const id;
+    ResourceUsage prevUsage;
+    uint64_t prevTotal[MemoryAccounting::NUM_KINDS];
+
+public:
+    /**
+     * Sets the output stream of the trace.
+     * @param os the output stream or null to stop recording.
+     * @param fmt the output format.
+     * @return the previous output stream.
+     */
+    static std::ostream* setOutput(std::ostream* os, Format fmt = JSON) {
+        std::ostream* prev = sink();
+        sink() = os;
+        format() = fmt;
+        if (os && fmt == CSV) {
+            *os << "id,op,name,level,states,unique,nodes,dead,swept,"
+                    "slots,probes,load,wall,cpu,rss_kb";
+            for (int k = 0; k < MemoryAccounting::NUM_KINDS; ++k) {
+                char const* s =
+                        MemoryAccounting::name(MemoryAccounting::Kind(k));
+                *os << "," << s << "_live," << s << "_alloc";
+            }
+            *os << "\n";
+        }
+        return prev;
+    }
+
+    /**
+     * Checks if the trace is being recorded.
+     * @return true if an output stream is set.
+     */
+    static bool enabled() {
+        return sink() != 0;
+    }
+
+    /**
+     * Gets the type name of the subject of an operation.
+     * The name is made only while the trace is being recorded.
+     * @param obj the subject.
+     * @return the type name or an empty string.
+     */
+    template<typename T>
+    static std::string nameOf(T const& obj) {
+        return enabled() ? typenameof(obj) : std::string();
+    }
+
+    /**
+     * Constructor.
+     * Nothing is measured unless the trace is being recorded.
+     * @param op the operation such as "build" and "reduce".
+     * @param name the subject of the operation.
+     */
+    Telemetry(char const* op, std::string const& name = "") :
+            op(op), name(name), id(enabled() ? ++lastId() : 0),
+            prevUsage(0, 0, 0, 0) {
+        if (id == 0) return;
+        prevUsage.update();
+        for (int k = 0; k < MemoryAccounting::NUM_KINDS; ++k) {
+            prevTotal[k] =
+                    MemoryAccounting::get(MemoryAccounting::Kind(k)).total;
+        }
+    }
+
+    /**
+     * Writes a record of one level.
+     * The time and memory are measured from the previous record
+     * or from the construction of this object.
+     * @param level the level.
+     * @param stats the counters of the level.
+     */
+    void record(int level, LevelStats const& stats) {
+        std::ostream* os = sink();
+        if (os == 0 || id == 0) return;
+
+        ResourceUsage usage;
+        double wall = usage.etime - prevUsage.etime;
+        double cpu = (usage.utime + usage.stime)
+                - (prevUsage.utime + prevUsage.stime);
+        long rss = usage.maxrss - prevUsage.maxrss;
+        double load = stats.slots ? double(stats.unique) / stats.slots : 0;
+        prevUsage = usage;
+
+        std::ios_base::fmtflags backup = os->flags(std::ios::fixed);
+        std::streamsize prec = os->precision(6);
+
+        if (format() == CSV) {
+            *os << id << "," << op << ",\"" << name << "\"," << level << ","
+                    << stats.states << "," << stats.unique << ","
+                    << stats.nodes << "," << stats.dead << ","
+                    << stats.swept << "," << stats.slots << ","
+                    << stats.probes << "," << load << "," << wall << ","
+                    << cpu << "," << rss;
+            for (int k = 0; k < MemoryAccounting::NUM_KINDS; ++k) {
+                MemoryAccounting::Counter c =
+                        MemoryAccounting::get(MemoryAccounting::Kind(k));
+                *os << "," << c.live << "," << c.total - prevTotal[k];
+                prevTotal[k] = c.total;
+            }
+            *os << "\n";
+        }
+        else {
+            *os << "{\"id\":" << id << ",\"op\":\"" << op << "\",\"name\":\""
+                    << name << "\",\"level\":" << level << ",\"states\":"
+                    << stats.states << ",\"unique\":" << stats.unique
+                    << ",\"nodes\":" << stats.nodes << ",\"dead\":"
+                    << stats.dead << ",\"swept\":" << stats.swept
+                    << ",\"slots\":" << stats.slots << ",\"probes\":"
+                    << stats.probes << ",\"load\":" << load << ",\"wall\":"
+                    << wall << ",\"cpu\":" << cpu << ",\"rss_kb\":" << rss
+                    << ",\"memory\":{";
+            for (int k = 0; k < MemoryAccounting::NUM_KINDS; ++k) {
+                MemoryAccounting::Counter c =
+                        MemoryAccounting::get(MemoryAccounting::Kind(k));
+                if (k != 0) *os << ",";
+                *os << "\""
+                        << MemoryAccounting::name(MemoryAccounting::Kind(k))
+                        << "\":{\"live\":" << c.live << ",\"alloc\":"
+                        << c.total - prevTotal[k] << "}";
+                prevTotal[k] = c.total;
+            }
+            *os << "}}\n";
+        }
+
+        os->precision(prec);
+        os->flags(backup);
+    }
+};
+
+} // namespace tdzdd
@@ -0,0 +1,141 @@
+/*
+ * TdZdd: a Top-down/Breadth-first Decision Diagram Manipulation Framework
+ * by Hiroaki Iwashita <iwashita@erato.ist.hokudai.ac.jp>
+ * Copyright (c) 2014 ERATO MINATO Project
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define TDZDD_X86_SIMD
+#endif
+
+namespace tdzdd {
+
+/**
+ * Hashing and comparison of state arrays of machine words.
+ * Arrays of LANES or more words are hashed by independent multiply-add
+ * chains combined at the end.
+ * Arrays of SIMD_WORDS or more words are compared by AVX2 instructions
+ * when the CPU supports them.
+ * Shorter arrays are handled by simple loops.
+ */
+struct WordArray {
+    typedef size_t Word;
+
+    static int const LANES = 4; ///< number of independent hash chains.
+    static int const SIMD_WORDS = 16; ///< minimum words for AVX2 comparison.
+
+    /**
+     * Computes the hash code of a word array.
+     * @param p pointer to the array.
+     * @param n the number of words.
+     * @return the hash code.
+     */
+    static size_t hash(Word const* p, int n) {
+        Word const* pz = p + n;
+        size_t h = 0;
+
+        if (n >= LANES) {
+            size_t h1 = 0, h2 = 0, h3 = 0;
+            Word const* pp = p + (n & ~(LANES - 1));
+
+            while (p != pp) {
+                h += p[0];
+                h1 += p[1];
+                h2 += p[2];
+                h3 += p[3];
+                h *= 314159257;
+                h1 *= 314159257;
+                h2 *= 314159257;
+                h3 *= 314159257;
+                p += LANES;
+            }
+
+            h = ((h * 271828171 + h1) * 271828171 + h2) * 271828171 + h3;
+        }
+
+        while (p != pz) {
+            h += *p++;
+            h *= 314159257;
+        }
+
+        return h;
+    }
+
+    /**
+     * Compares two word arrays.
+     * @param p pointer to an array.
+     * @param q pointer to the other array.
+     * @param n the number of words.
+     * @return true if they are equal.
+     */
+    static bool equal(Word const* p, Word const* q, int n) {
+#ifdef TDZDD_X86_SIMD
+        if (n >= SIMD_WORDS && hasAvx2()) return equalAvx2(p, q, n);
+#endif
+        for (Word const* pz = p + n; p != pz; ++p, ++q) {
+            if (*p != *q) return false;
+        }
+        return true;
+    }
+
+#ifdef TDZDD_X86_SIMD
+    /**
+     * Checks if the CPU supports AVX2.
+     * @return true if AVX2 instructions can be used.
+     */
+    static bool hasAvx2() {
+#ifdef __AVX2__
+        return true;
+#else
+        static bool const avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+#endif
+    }
+
+private:
+    __attribute__((target("avx2")))
+    static bool equalAvx2(Word const* p, Word const* q, int n) {
+        int const step = sizeof(__m256i) / sizeof(Word);
+        Word const* pz = p + n - n % step;
+
+        for (; p != pz; p += step, q += step) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(p));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(q));
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) != -1) {
+                return false;
+            }
+        }
+
+        for (pz += n % step; p != pz; ++p, ++q) {
+            if (*p != *q) return false;
+        }
+        return true;
+    }
+#endif
+};
+
+} // namespace tdzdd